@@ -0,0 +1,211 @@
+// Benchmark of the snake body follow step (Snake::Tick movement loop).
+//
+// Compares the previous array-of-structs loop against the SoA BodyKernel
+// path for 2 to max_snake_parts long snakes, and checks that the SIMD
+// kernel stays within BodyKernel::follow_tolerance of the reference.
+//
+//   ./bin/bench_body_follow [iterations_scale]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "game/body.h"
+#include "game/config.h"
+#include "game/snake.h"
+
+namespace {
+
+const size_t skip = Snake::parts_skip_count;
+const size_t start_move = Snake::parts_start_move_count;
+const float tail_k = Snake::snake_tail_k;
+
+// Body of a snake coiled along an arc, head first.
+std::vector<Body> MakeBody(size_t len) {
+  std::vector<Body> body;
+  float x = WorldConfig::game_radius;
+  float y = WorldConfig::game_radius;
+  float ang = 0.0f;
+  for (size_t i = 0; i < len; ++i) {
+    body.push_back(Body{x, y});
+    const float step = i < skip + start_move ? WorldConfig::move_step_distance
+                                             : Snake::tail_step_distance;
+    x -= cosf(ang) * step;
+    y -= sinf(ang) * step;
+    ang += 0.05f;
+  }
+  return body;
+}
+
+// The array-of-structs movement loop as it was before the SoA layout.
+void StepAoS(std::vector<Body> *parts, float dx, float dy, float *cx, float *cy) {
+  const size_t len = parts->size();
+  Body &head = (*parts)[0];
+  Body prev = head;
+  head.x += dx;
+  head.y += dy;
+
+  float bbx = head.x;
+  float bby = head.y;
+
+  for (size_t i = 1; i < len && i < skip; ++i) {
+    const Body old = (*parts)[i];
+    (*parts)[i] = prev;
+    bbx += prev.x;
+    bby += prev.y;
+    prev = old;
+  }
+
+  for (size_t i = skip, j = 0; i < len && i < skip + start_move; ++i) {
+    Body &pt = (*parts)[i];
+    const Body last = (*parts)[i - 1];
+    const Body old = pt;
+    pt.From(prev);
+    const float move_coeff = tail_k * (++j) / start_move;
+    pt.Offset(move_coeff * (last.x - pt.x), move_coeff * (last.y - pt.y));
+    bbx += pt.x;
+    bby += pt.y;
+    prev = old;
+  }
+
+  for (size_t i = skip + start_move; i < len; ++i) {
+    Body &pt = (*parts)[i];
+    const Body last = (*parts)[i - 1];
+    const Body old = pt;
+    pt.From(prev);
+    pt.Offset(tail_k * (last.x - pt.x), tail_k * (last.y - pt.y));
+    bbx += pt.x;
+    bby += pt.y;
+    prev = old;
+  }
+
+  *cx = bbx / len;
+  *cy = bby / len;
+}
+
+// Same step on the SoA layout, mirroring Snake::Tick.
+void StepSoA(BodySeq *parts, std::vector<float> *old_parts, float dx, float dy,
+             float *cx, float *cy) {
+  const size_t len = parts->size();
+  old_parts->resize(2 * len);
+  float *px = parts->x_data();
+  float *py = parts->y_data();
+  std::memcpy(old_parts->data(), px, len * sizeof(float));
+  std::memcpy(old_parts->data() + len, py, len * sizeof(float));
+  const float *ox = old_parts->data();
+  const float *oy = old_parts->data() + len;
+
+  px[0] += dx;
+  py[0] += dy;
+
+  const size_t skip_end = std::min(len, skip);
+  for (size_t i = 1; i < skip_end; ++i) {
+    px[i] = ox[i - 1];
+    py[i] = oy[i - 1];
+  }
+
+  const size_t start_end = std::min(len, skip + start_move);
+  for (size_t i = skip, j = 0; i < start_end; ++i) {
+    const float move_coeff = tail_k * (++j) / start_move;
+    px[i] = ox[i - 1] + move_coeff * (px[i - 1] - ox[i - 1]);
+    py[i] = oy[i - 1] + move_coeff * (py[i - 1] - oy[i - 1]);
+  }
+
+  BodyKernel::FollowTail(px, py, ox, oy, start_end, len, tail_k);
+
+  float bbx = 0.0f;
+  float bby = 0.0f;
+  BodyKernel::Sum(px, py, len, &bbx, &bby);
+  *cx = bbx / len;
+  *cy = bby / len;
+}
+
+BodySeq ToSoA(const std::vector<Body> &body) {
+  BodySeq seq;
+  for (const Body &b : body) seq.push_back(b);
+  return seq;
+}
+
+double NowNs() {
+  using std::chrono::duration_cast;
+  using std::chrono::nanoseconds;
+  using std::chrono::steady_clock;
+  return static_cast<double>(
+      duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const double scale = argc > 1 ? atof(argv[1]) : 1.0;
+  const size_t lengths[] = {2, 3, 5, 7, 8, 16, 32, 64, 128, 256,
+                            WorldConfig::max_snake_parts};
+
+  volatile float sink = 0.0f;
+  float worst = 0.0f;
+
+  printf("%8s %10s %10s %8s %12s\n", "parts", "aos ns", "soa ns", "speedup",
+         "max err");
+
+  for (size_t len : lengths) {
+    const std::vector<Body> start = MakeBody(len);
+    const size_t iters =
+        static_cast<size_t>(scale * std::max<size_t>(20000, 4000000 / len));
+
+    // accuracy: one step of both paths from identical, partially moved state
+    float max_err = 0.0f;
+    for (int n = 0; n < 256; ++n) {
+      const float dx = cosf(0.0245f * n) * 42.0f;
+      const float dy = sinf(0.0245f * n) * 42.0f;
+      float acx, acy, bcx, bcy;
+      std::vector<Body> ref = start;
+      for (int step = 0; step < n % 16; ++step) {
+        StepAoS(&ref, dx, dy, &acx, &acy);
+      }
+
+      BodySeq b = ToSoA(ref);
+      std::vector<float> old;
+      StepAoS(&ref, dx, dy, &acx, &acy);
+      StepSoA(&b, &old, dx, dy, &bcx, &bcy);
+      for (size_t i = 0; i < len; ++i) {
+        max_err = std::max(max_err, std::fabs(ref[i].x - b[i].x));
+        max_err = std::max(max_err, std::fabs(ref[i].y - b[i].y));
+      }
+      max_err = std::max(max_err, std::fabs(acx - bcx));
+      max_err = std::max(max_err, std::fabs(acy - bcy));
+    }
+    worst = std::max(worst, max_err);
+
+    // timing, the head walks a slow circle
+    std::vector<Body> a = start;
+    float cx = 0.0f, cy = 0.0f;
+    double t0 = NowNs();
+    for (size_t n = 0; n < iters; ++n) {
+      const float ang = 0.001f * n;
+      StepAoS(&a, cosf(ang) * 42.0f, sinf(ang) * 42.0f, &cx, &cy);
+    }
+    const double aos_ns = (NowNs() - t0) / iters;
+    sink = sink + cx + cy;
+
+    BodySeq b = ToSoA(start);
+    std::vector<float> old;
+    t0 = NowNs();
+    for (size_t n = 0; n < iters; ++n) {
+      const float ang = 0.001f * n;
+      StepSoA(&b, &old, cosf(ang) * 42.0f, sinf(ang) * 42.0f, &cx, &cy);
+    }
+    const double soa_ns = (NowNs() - t0) / iters;
+    sink = sink + cx + cy;
+
+    printf("%8zu %10.1f %10.1f %7.2fx %12.6f\n", len, aos_ns, soa_ns,
+           aos_ns / soa_ns, max_err);
+  }
+
+  printf("tolerance %.6f, worst %.6f: %s\n", BodyKernel::follow_tolerance,
+         worst, worst <= BodyKernel::follow_tolerance ? "ok" : "FAILED");
+  return worst <= BodyKernel::follow_tolerance ? 0 : 1;
+}
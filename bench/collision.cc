@@ -0,0 +1,149 @@
+// Micro-benchmark of the narrow-phase head vs body test used by
+// World::CheckSnakeBounds.
+//
+// Compares Collision::HeadHitsBodyScalar (Math::dist_sq and
+// Math::check_intersection per part) with the batched SIMD
+// Collision::HeadHitsBody on crowded and sparse scenes.
+//
+//   ./bin/bench_collision [iterations_scale]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "game/body.h"
+#include "game/collision.h"
+#include "game/config.h"
+#include "game/snake.h"
+
+namespace {
+
+struct Head {
+  float hx, hy, px, py;
+};
+
+struct Scene {
+  std::vector<BodySeq> bodies;
+  std::vector<Head> heads;
+};
+
+// `snakes` bodies wandering inside a square of side `area` around the map
+// center, plus `heads` moving heads placed in the same square.
+Scene MakeScene(std::mt19937 *rng, size_t snakes, size_t heads, float area) {
+  std::uniform_real_distribution<float> pos(WorldConfig::game_radius - area / 2,
+                                            WorldConfig::game_radius + area / 2);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  std::uniform_int_distribution<size_t> len(20, WorldConfig::max_snake_parts);
+
+  Scene scene;
+  for (size_t s = 0; s < snakes; ++s) {
+    BodySeq body;
+    float x = pos(*rng);
+    float y = pos(*rng);
+    float ang = Math::f_2pi * unit(*rng);
+    const size_t n = len(*rng);
+    for (size_t i = 0; i < n; ++i) {
+      body.push_back(Body{x, y});
+      x -= cosf(ang) * Snake::tail_step_distance;
+      y -= sinf(ang) * Snake::tail_step_distance;
+      ang += (unit(*rng) - 0.5f) * 0.3f;
+    }
+    scene.bodies.push_back(body);
+  }
+
+  for (size_t h = 0; h < heads; ++h) {
+    const float hx = pos(*rng);
+    const float hy = pos(*rng);
+    const float ang = Math::f_2pi * unit(*rng);
+    scene.heads.push_back(Head{hx, hy, hx - cosf(ang) * 5.0f, hy - sinf(ang) * 5.0f});
+  }
+  return scene;
+}
+
+double NowNs() {
+  using std::chrono::duration_cast;
+  using std::chrono::nanoseconds;
+  using std::chrono::steady_clock;
+  return static_cast<double>(
+      duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+typedef bool (*HitFn)(const float *, const float *, size_t, float, float, float,
+                      float, float);
+
+// Runs every head against every body, returns ns per head/body pair.
+double Run(const Scene &scene, HitFn fn, float hit_dist_sq, size_t reps,
+           size_t *hits) {
+  size_t h_count = 0;
+  const double t0 = NowNs();
+  for (size_t r = 0; r < reps; ++r) {
+    h_count = 0;
+    for (const Head &h : scene.heads) {
+      for (const BodySeq &b : scene.bodies) {
+        h_count += fn(b.x_data(), b.y_data(), b.size(), h.hx, h.hy, h.px, h.py,
+                      hit_dist_sq);
+      }
+    }
+  }
+  *hits = h_count;
+  return (NowNs() - t0) / (reps * scene.heads.size() * scene.bodies.size());
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const double scale = argc > 1 ? atof(argv[1]) : 1.0;
+  std::mt19937 rng(42);
+
+  struct Config {
+    const char *name;
+    size_t snakes;
+    size_t heads;
+    float area;
+  };
+  const Config configs[] = {
+      {"crowded", 64, 256, 1500.0f},
+      {"busy", 64, 256, 4000.0f},
+      {"sparse", 64, 256, 12000.0f},
+  };
+
+  const float hit_r = 29.0f;  // two base size snakes, lsz / 2 each
+  const float hit_dist_sq = hit_r * hit_r;
+  const size_t reps = static_cast<size_t>(std::max(1.0, 20 * scale));
+
+  printf("%-8s %8s %12s %12s %8s %8s %10s\n", "scene", "parts", "scalar ns",
+         "simd ns", "speedup", "hits", "mismatch");
+
+  for (const Config &c : configs) {
+    const Scene scene = MakeScene(&rng, c.snakes, c.heads, c.area);
+
+    size_t parts = 0;
+    for (const BodySeq &b : scene.bodies) parts += b.size();
+
+    size_t mismatch = 0;
+    for (const Head &h : scene.heads) {
+      for (const BodySeq &b : scene.bodies) {
+        const bool a = Collision::HeadHitsBodyScalar(
+            b.x_data(), b.y_data(), b.size(), h.hx, h.hy, h.px, h.py, hit_dist_sq);
+        const bool v = Collision::HeadHitsBody(
+            b.x_data(), b.y_data(), b.size(), h.hx, h.hy, h.px, h.py, hit_dist_sq);
+        mismatch += a != v;
+      }
+    }
+
+    size_t scalar_hits = 0;
+    size_t simd_hits = 0;
+    const double scalar_ns =
+        Run(scene, &Collision::HeadHitsBodyScalar, hit_dist_sq, reps, &scalar_hits);
+    const double simd_ns =
+        Run(scene, &Collision::HeadHitsBody, hit_dist_sq, reps, &simd_hits);
+
+    printf("%-8s %8zu %12.1f %12.1f %7.2fx %8zu %10zu\n", c.name, parts,
+           scalar_ns, simd_ns, scalar_ns / simd_ns, simd_hits, mismatch);
+  }
+
+  return 0;
+}
@@ -0,0 +1,184 @@
+// Benchmark of the per-sector food container (Sector::food).
+//
+// Compares the previous x-sorted std::vector<Food> against FoodStore on
+// sectors filled with 20 to 5000 pellets: spawning (Insert), eating (find
+// the pellet and remove it) and the mouth radius query FindEatenFood runs.
+// Each round spawns a quarter of the base count, at most 256, so small
+// sectors stay small.
+// Both must report the same pellets in reach.
+//
+//   ./bin/bench_food_store [iterations_scale]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "game/config.h"
+#include "game/food.h"
+#include "game/food_store.h"
+
+namespace {
+
+const uint16_t origin = WorldConfig::sector_size * 45;
+
+bool ByX(const Food &a, const Food &b) { return a.x < b.x; }
+
+bool Same(const Food &a, const Food &b) {
+  return a.x == b.x && a.y == b.y && a.size == b.size && a.color == b.color;
+}
+
+// The container Sector::food used to be.
+struct SortedFood {
+  FoodSeq food;
+
+  void Insert(Food f) {
+    food.insert(std::lower_bound(food.begin(), food.end(), f, ByX), f);
+  }
+
+  bool Eat(const Food &f) {
+    for (auto it = std::lower_bound(food.begin(), food.end(), f, ByX);
+         it != food.end() && it->x == f.x; ++it) {
+      if (Same(*it, f)) {
+        food.erase(it);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  size_t CountInRadius(float x, float y, float r) const {
+    const float r_sq = r * r;
+    size_t n = 0;
+    auto it = std::lower_bound(food.begin(), food.end(), x - r,
+                               [](const Food &a, float v) { return a.x < v; });
+    for (; it != food.end() && it->x <= x + r; ++it) {
+      const float dx = it->x - x;
+      const float dy = it->y - y;
+      n += dx * dx + dy * dy < r_sq;
+    }
+    return n;
+  }
+};
+
+struct StoreFood {
+  FoodStore food;
+
+  StoreFood() { food.SetOrigin(origin, origin); }
+
+  void Insert(Food f) { food.Insert(f); }
+
+  bool Eat(const Food &f) {
+    const size_t i = food.Find(f);
+    if (i == food.size()) {
+      return false;
+    }
+    food.Remove(i);
+    return true;
+  }
+
+  size_t CountInRadius(float x, float y, float r) const {
+    size_t n = 0;
+    food.ForEachInRadius(x, y, r, [&](const Food &) {
+      n++;
+      return false;
+    });
+    return n;
+  }
+};
+
+std::vector<Food> MakeFood(std::mt19937 *rng, size_t n) {
+  std::uniform_int_distribution<uint16_t> pos(0, WorldConfig::sector_size - 1);
+  std::uniform_int_distribution<uint16_t> val(1, 10);
+  std::vector<Food> food;
+  for (size_t i = 0; i < n; ++i) {
+    food.push_back(Food{static_cast<uint16_t>(origin + pos(*rng)),
+                        static_cast<uint16_t>(origin + pos(*rng)),
+                        static_cast<uint8_t>(val(*rng)), static_cast<uint8_t>(val(*rng))});
+  }
+  return food;
+}
+
+double NowNs() {
+  using std::chrono::duration_cast;
+  using std::chrono::nanoseconds;
+  using std::chrono::steady_clock;
+  return static_cast<double>(
+      duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+struct Result {
+  double spawn_ns;
+  double eat_ns;
+  double query_ns;
+  size_t found;
+};
+
+// Fills a sector with `base`, then per rep spawns `churn` more pellets and
+// eats them again in random order, and runs `queries` mouth queries.
+template <typename C>
+Result Run(const std::vector<Food> &base, const std::vector<Food> &churn,
+           const std::vector<Food> &eat_order, const std::vector<float> &queries,
+           size_t reps) {
+  C c;
+  for (const Food &f : base) c.Insert(f);
+
+  Result res = {0, 0, 0, 0};
+  for (size_t r = 0; r < reps; ++r) {
+    double t0 = NowNs();
+    for (const Food &f : churn) c.Insert(f);
+    res.spawn_ns += NowNs() - t0;
+
+    t0 = NowNs();
+    size_t found = 0;
+    for (size_t q = 0; q + 1 < queries.size(); q += 2) {
+      found += c.CountInRadius(queries[q], queries[q + 1], 60.0f);
+    }
+    res.query_ns += NowNs() - t0;
+    res.found = found;
+
+    t0 = NowNs();
+    for (const Food &f : eat_order) c.Eat(f);
+    res.eat_ns += NowNs() - t0;
+  }
+
+  res.spawn_ns /= reps * churn.size();
+  res.eat_ns /= reps * eat_order.size();
+  res.query_ns /= reps * (queries.size() / 2);
+  return res;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const double scale = argc > 1 ? atof(argv[1]) : 1.0;
+  std::mt19937 rng(42);
+
+  const size_t densities[] = {20, 50, 500, 5000};
+
+  printf("%-6s %10s %10s %10s %10s %10s %10s %8s\n", "food", "spawn old",
+         "spawn new", "eat old", "eat new", "query old", "query new", "match");
+
+  for (size_t density : densities) {
+    const std::vector<Food> base = MakeFood(&rng, density);
+    const std::vector<Food> churn = MakeFood(&rng, std::min<size_t>(density / 4, 256));
+    std::vector<Food> eat_order = churn;
+    std::shuffle(eat_order.begin(), eat_order.end(), rng);
+
+    std::uniform_real_distribution<float> pos(origin, origin + WorldConfig::sector_size);
+    std::vector<float> queries;
+    for (size_t q = 0; q < 512; ++q) queries.push_back(pos(rng));
+
+    const size_t reps = static_cast<size_t>(std::max(1.0, 200 * scale));
+    const Result prev = Run<SortedFood>(base, churn, eat_order, queries, reps);
+    const Result next = Run<StoreFood>(base, churn, eat_order, queries, reps);
+
+    printf("%-6zu %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f %8s\n", density,
+           prev.spawn_ns, next.spawn_ns, prev.eat_ns, next.eat_ns, prev.query_ns,
+           next.query_ns, prev.found == next.found ? "yes" : "NO");
+  }
+
+  return 0;
+}
@@ -0,0 +1,160 @@
+// Benchmark of the whole simulation without the network.
+//
+// Runs HeadlessSim (World plus the server's per-frame work) with N bots and
+// M scripted players, whose viewports are kept up to date, as fast as
+// possible. Reports frames per second, frame time percentiles and the mean
+// time per frame of each World::Tick phase (GetTickPhases), in ms; "server"
+// is the rest of the frame: respawn, spawn growth, dead snakes and update
+// flags. "view/fr" counts the sectors entering player viewports per frame.
+//
+// Without --bots it sweeps 100, 500, 1000 and 2000 snakes.
+//
+//   ./bin/bench_headless_sim [--bots N] [--humans M] [--frames F]
+//                            [--warmup W] [--threads T] [--seed S]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "game/headless_sim.h"
+
+namespace {
+
+struct Options {
+  int bots = -1;  // sweep
+  uint16_t humans = 8;
+  uint32_t frames = 1000;
+  uint32_t warmup = 200;
+  uint16_t threads = 1;
+  uint64_t seed = 1;
+};
+
+int64_t NowNs() {
+  using std::chrono::duration_cast;
+  using std::chrono::nanoseconds;
+  using std::chrono::steady_clock;
+  return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+double Ms(double ns) { return ns / 1e6; }
+
+void PrintHeader() {
+  printf("%-6s %-6s %8s %8s %8s %8s | %7s %7s %7s %7s %7s %7s | %9s\n", "snakes",
+         "humans", "fps", "mean ms", "p50 ms", "p99 ms", "bot_ai", "move",
+         "commit", "collide", "food", "server", "view/fr");
+}
+
+void Run(const Options &o, uint16_t bots) {
+  WorldConfig config;
+  config.bots = bots;
+  config.sim_threads = o.threads;
+  config.random_seed = o.seed;
+  HeadlessSim sim(config, o.humans);
+
+  // Snakes grow to their start length during the first frames.
+  for (uint32_t f = 0; f < o.warmup; f++) {
+    sim.Step();
+  }
+
+  std::vector<int64_t> frame_ns;
+  frame_ns.reserve(o.frames);
+  TickPhases sum;
+  const uint64_t view_start = sim.get_view_sectors();
+  const int64_t start = NowNs();
+  for (uint32_t f = 0; f < o.frames; f++) {
+    const int64_t t = NowNs();
+    sim.Step();
+    frame_ns.push_back(NowNs() - t);
+
+    const TickPhases &p = sim.get_world().GetTickPhases();
+    sum.bot_ai += p.bot_ai;
+    sum.move += p.move;
+    sum.commit += p.commit;
+    sum.collision += p.collision;
+    sum.food += p.food;
+  }
+  const int64_t total = NowNs() - start;
+
+  int64_t frames_total = 0;
+  for (int64_t ns : frame_ns) {
+    frames_total += ns;
+  }
+  const int64_t server = frames_total - sum.bot_ai - sum.move - sum.commit -
+                         sum.collision - sum.food;
+
+  std::sort(frame_ns.begin(), frame_ns.end());
+  const double n = static_cast<double>(o.frames);
+  printf("%-6zu %-6zu %8.1f %8.3f %8.3f %8.3f | %7.3f %7.3f %7.3f %7.3f %7.3f %7.3f | %9.2f\n",
+         sim.get_world().GetTickOrder().size(), sim.get_human_count(),
+         n * 1e9 / static_cast<double>(total), Ms(frames_total / n),
+         Ms(static_cast<double>(frame_ns[frame_ns.size() / 2])),
+         Ms(static_cast<double>(frame_ns[frame_ns.size() * 99 / 100])),
+         Ms(sum.bot_ai / n), Ms(sum.move / n), Ms(sum.commit / n),
+         Ms(sum.collision / n), Ms(sum.food / n), Ms(server / n),
+         static_cast<double>(sim.get_view_sectors() - view_start) / n);
+  fflush(stdout);
+}
+
+void Usage(FILE *out) {
+  fprintf(out,
+          "usage: bench_headless_sim [--bots N] [--humans M] [--frames F]\n"
+          "                          [--warmup W] [--threads T] [--seed S]\n");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options o;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h") {
+      Usage(stdout);
+      return 0;
+    }
+    if (i + 1 >= argc) {
+      fprintf(stderr, "missing value for %s\n", arg.c_str());
+      Usage(stderr);
+      return 2;
+    }
+    const char *value = argv[++i];
+    if (arg == "--bots") {
+      o.bots = atoi(value);
+    } else if (arg == "--humans") {
+      o.humans = static_cast<uint16_t>(atoi(value));
+    } else if (arg == "--frames") {
+      o.frames = static_cast<uint32_t>(atol(value));
+    } else if (arg == "--warmup") {
+      o.warmup = static_cast<uint32_t>(atol(value));
+    } else if (arg == "--threads") {
+      o.threads = static_cast<uint16_t>(atoi(value));
+    } else if (arg == "--seed") {
+      o.seed = strtoull(value, nullptr, 10);
+    } else {
+      fprintf(stderr, "unknown option %s\n", arg.c_str());
+      Usage(stderr);
+      return 2;
+    }
+  }
+  if (o.frames == 0) {
+    fprintf(stderr, "--frames must be positive\n");
+    return 2;
+  }
+
+  std::vector<uint16_t> sweep;
+  if (o.bots >= 0) {
+    sweep.push_back(static_cast<uint16_t>(o.bots));
+  } else {
+    for (int snakes : {100, 500, 1000, 2000}) {
+      sweep.push_back(static_cast<uint16_t>(std::max(0, snakes - o.humans)));
+    }
+  }
+
+  PrintHeader();
+  for (uint16_t bots : sweep) {
+    Run(o, bots);
+  }
+  return 0;
+}
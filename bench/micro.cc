@@ -0,0 +1,460 @@
+// Micro-benchmarks of the packet encoders and the geometry kernels.
+//
+// Every operator<< in packet/ encodes into a buffer that keeps its storage,
+// so only the encoding is timed, not the allocation of the server's
+// streambuf. The math cases run over 1024 prepared inputs per call and
+// report the time per input.
+//
+// Each case is calibrated to about --min-ms per sample and reports the
+// median of 5 samples. --json writes the results, one case per line;
+// --baseline reads such a file and compares, exiting with 1 when a case is
+// slower than --threshold percent.
+//
+//   ./bin/bench_micro [--filter S] [--min-ms N] [--json out.json]
+//                     [--baseline base.json] [--threshold P]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "game/math.h"
+#include "game/snake.h"
+#include "packet/d_all.h"
+#include "packet/p_all.h"
+
+namespace {
+
+struct Options {
+  std::string filter;
+  double min_ms = 20.0;
+  std::string json;
+  std::string baseline;
+  double threshold = 10.0;
+};
+
+struct Result {
+  std::string name;
+  double ns;     // per call, or per input for the batched cases
+  size_t bytes;  // encoded size, 0 for the math cases
+};
+
+int64_t NowNs() {
+  using std::chrono::duration_cast;
+  using std::chrono::nanoseconds;
+  using std::chrono::steady_clock;
+  return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Keeps results alive so the compiler cannot drop the timed work.
+volatile uint64_t sink_u;
+volatile float sink_f;
+
+// An output buffer that grows like std::stringbuf but keeps its storage
+// when reset for the next packet.
+class PacketBuf : public std::streambuf {
+ public:
+  PacketBuf() : data(1024) { Reset(); }
+  void Reset() { setp(data.data(), data.data() + data.size()); }
+  size_t size() const { return static_cast<size_t>(pptr() - pbase()); }
+
+ protected:
+  int_type overflow(int_type c) override {
+    if (traits_type::eq_int_type(c, traits_type::eof())) {
+      return traits_type::not_eof(c);
+    }
+    const size_t used = size();
+    data.resize(data.size() * 2);
+    setp(data.data(), data.data() + data.size());
+    pbump(static_cast<int>(used));
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+    return c;
+  }
+
+ private:
+  std::vector<char> data;
+};
+
+class Suite {
+ public:
+  explicit Suite(const Options &o) : options(o) {}
+
+  // Times f(), which does `batch` units of work, per unit.
+  void Add(const std::string &name, size_t batch, size_t bytes,
+           const std::function<void()> &f);
+
+  template <typename P>
+  void Encode(const std::string &name, const P &packet);
+
+  const std::vector<Result> &get_results() const { return results; }
+
+ private:
+  const Options &options;
+  std::vector<Result> results;
+  PacketBuf buf;
+};
+
+void Suite::Add(const std::string &name, size_t batch, size_t bytes,
+                const std::function<void()> &f) {
+  if (name.find(options.filter) == std::string::npos) {
+    return;
+  }
+
+  const int64_t min_ns = static_cast<int64_t>(options.min_ms * 1e6);
+  size_t iters = 1;
+  for (;;) {
+    const int64_t t = NowNs();
+    for (size_t i = 0; i < iters; i++) f();
+    if (NowNs() - t >= min_ns || iters >= (size_t(1) << 30)) break;
+    iters *= 2;
+  }
+
+  std::vector<double> samples;
+  for (int s = 0; s < 5; s++) {
+    const int64_t t = NowNs();
+    for (size_t i = 0; i < iters; i++) f();
+    samples.push_back(static_cast<double>(NowNs() - t) / (iters * batch));
+  }
+  std::sort(samples.begin(), samples.end());
+
+  results.push_back(Result{name, samples[2], bytes});
+  printf("%-40s %12.2f ns %8zu B\n", name.c_str(), samples[2], bytes);
+  fflush(stdout);
+}
+
+template <typename P>
+void Suite::Encode(const std::string &name, const P &packet) {
+  std::ostream out(&buf);
+  buf.Reset();
+  out << packet;
+  const size_t bytes = buf.size();
+  Add("encode/" + name, 1, bytes, [&] {
+    buf.Reset();
+    out << packet;
+    sink_u = sink_u + buf.size();
+  });
+}
+
+std::shared_ptr<Snake> MakeSnake(std::mt19937 *rng, snake_id_t id, size_t parts) {
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  std::shared_ptr<Snake> s = std::make_shared<Snake>();
+  s->id = id;
+  s->name = "snake " + std::to_string(id);
+  s->skin = static_cast<uint8_t>(id % 40);
+  s->speed = 185;
+  s->angle = Math::f_2pi * unit(*rng);
+  s->wangle = Math::f_2pi * unit(*rng);
+  s->fullness = 40;
+
+  float x = WorldConfig::game_radius;
+  float y = WorldConfig::game_radius;
+  float ang = s->angle;
+  for (size_t i = 0; i < parts; i++) {
+    s->parts.push_back(Body{x, y});
+    x -= cosf(ang) * Snake::tail_step_distance;
+    y -= sinf(ang) * Snake::tail_step_distance;
+    ang += (unit(*rng) - 0.5f) * 0.3f;
+  }
+  return s;
+}
+
+std::vector<Food> MakeSectorFood(std::mt19937 *rng, size_t n) {
+  const uint16_t origin = WorldConfig::sector_size * 45;
+  std::uniform_int_distribution<uint16_t> pos(0, WorldConfig::sector_size - 1);
+  std::uniform_int_distribution<uint16_t> val(1, 10);
+  std::vector<Food> food;
+  for (size_t i = 0; i < n; i++) {
+    food.push_back(Food{static_cast<uint16_t>(origin + pos(*rng)),
+                        static_cast<uint16_t>(origin + pos(*rng)),
+                        static_cast<uint8_t>(val(*rng)), static_cast<uint8_t>(val(*rng))});
+  }
+  return food;
+}
+
+packet_rotation Rotation(float ang, float wang, float speed) {
+  packet_rotation p;
+  p.snakeId = 42;
+  p.ang = ang;
+  p.wang = wang;
+  p.snakeSpeed = speed;
+  return p;
+}
+
+void AddPacketCases(Suite *suite, std::mt19937 *rng) {
+  const std::shared_ptr<Snake> big = MakeSnake(rng, 1, 400);
+  const std::shared_ptr<Snake> small = MakeSnake(rng, 2, 10);
+  const Food pellet = {10820, 10100, 7, 3};
+
+  suite->Encode("add_snake_400_legacy", packet_add_snake(big.get(), false));
+  suite->Encode("add_snake_400_modern", packet_add_snake(big.get(), true));
+  suite->Encode("add_snake_10", packet_add_snake(small.get(), false));
+  suite->Encode("remove_snake", packet_remove_snake(1, packet_remove_snake::status_snake_died));
+
+  // a full sector holds 20 pellets, dead snakes leave many more
+  const std::vector<Food> sector_food = MakeSectorFood(rng, 20);
+  const std::vector<Food> death_food = MakeSectorFood(rng, 200);
+  suite->Encode("set_food_rel_20", packet_set_food_rel(&sector_food));
+  suite->Encode("set_food_rel_200", packet_set_food_rel(&death_food));
+  suite->Encode("set_food_abs_20", packet_set_food_abs(&sector_food));
+  suite->Encode("set_food_abs_200", packet_set_food_abs(&death_food));
+  suite->Encode("spawn_food_legacy", packet_spawn_food(pellet, false));
+  suite->Encode("spawn_food_modern", packet_spawn_food(pellet, true));
+  suite->Encode("add_food_legacy", packet_add_food(pellet, false));
+  suite->Encode("add_food_modern", packet_add_food(pellet, true));
+  suite->Encode("eat_food_legacy", packet_eat_food(1, pellet, 14));
+  suite->Encode("eat_food_modern", packet_eat_food(1, pellet, 31));
+
+  // one case per packet type get_rot_type picks
+  suite->Encode("rotation_ang", Rotation(1.0f, -1.0f, -1.0f));
+  suite->Encode("rotation_sp", Rotation(-1.0f, -1.0f, 5.8f));
+  suite->Encode("rotation_ang_sp", Rotation(1.0f, -1.0f, 5.8f));
+  suite->Encode("rotation_wang", Rotation(-1.0f, 2.0f, -1.0f));
+  suite->Encode("rotation_wang_sp", Rotation(-1.0f, 2.0f, 5.8f));
+  suite->Encode("rotation_ang_wang_cw", Rotation(1.0f, 2.0f, -1.0f));
+  suite->Encode("rotation_ang_wang_ccw", Rotation(2.0f, 1.0f, -1.0f));
+  suite->Encode("rotation_ang_wang_sp_cw", Rotation(1.0f, 2.0f, 5.8f));
+  suite->Encode("rotation_ang_wang_sp_ccw", Rotation(2.0f, 1.0f, 5.8f));
+
+  packet_leaderboard leaderboard;
+  leaderboard.leaderboard_rank = 3;
+  leaderboard.local_rank = 3;
+  leaderboard.players = 500;
+  for (snake_id_t id = 10; id < 20; id++) {
+    leaderboard.top.emplace_back(MakeSnake(rng, id, 50).get());
+  }
+  suite->Encode("leaderboard_10", leaderboard);
+
+  packet_highscore highscore;
+  highscore.winner = big;
+  highscore.message = "well played";
+  suite->Encode("highscore", highscore);
+
+  // about the size the server sends for a populated map
+  std::uniform_int_distribution<int> byte(0, 255);
+  packet_minimap minimap(144);
+  for (size_t i = 0; i < 850; i++) {
+    minimap.data.push_back(static_cast<uint8_t>(byte(*rng)));
+  }
+  suite->Encode("minimap_modern", minimap);
+  minimap.packet_type = packet_t_minimap_legacy;
+  suite->Encode("minimap_legacy", minimap);
+
+  suite->Encode("move", packet_move(big.get()));
+  suite->Encode("move_rel", packet_move_rel(42, 3, -2));
+  suite->Encode("inc", packet_inc(big.get()));
+  suite->Encode("inc_rel", packet_inc_rel(42, 131, 126, 40));
+  suite->Encode("remove_part", packet_remove_part(big.get()));
+  suite->Encode("fullness", packet_fullness(big.get()));
+  suite->Encode("add_sector", packet_add_sector(45, 46));
+  suite->Encode("remove_sector", packet_remove_sector(45, 46));
+  suite->Encode("end", packet_end(packet_end::status_death));
+  suite->Encode("kill", packet_kill());
+  suite->Encode("init", PacketInit());
+  suite->Encode("pre_init", packet_pre_init());
+  suite->Encode("pong", packet_pong());
+
+  packet_debug_draw draw;
+  for (uint24_t i = 0; i < 50; i++) {
+    const d_draw_point a(static_cast<uint16_t>(100 + i), static_cast<uint16_t>(200 + i));
+    const d_draw_point b(static_cast<uint16_t>(300 + i), static_cast<uint16_t>(400 + i));
+    draw.dots.push_back(d_draw_dot{i, a, 0x646464});
+    draw.segments.push_back(d_draw_segment{i, a, b, 0x646464});
+    draw.rects.push_back(d_draw_rect{i, a, b, 0x646464});
+    draw.circles.push_back(d_draw_circle(i, a, 50.0f, 0x646464));
+  }
+  suite->Encode("debug_draw_200", draw);
+  suite->Encode("debug_reset", packet_debug_reset());
+}
+
+void AddMathCases(Suite *suite, std::mt19937 *rng) {
+  const size_t n = 1024;
+  std::uniform_real_distribution<float> pos(0.0f, 2.0f * WorldConfig::game_radius);
+  std::uniform_real_distribution<float> near(-20.0f, 20.0f);
+  std::uniform_real_distribution<float> angle(-4.0f * Math::f_pi, 4.0f * Math::f_pi);
+
+  // segments of a few units, as a head step against a body step
+  std::shared_ptr<std::vector<float>> seg = std::make_shared<std::vector<float>>();
+  for (size_t i = 0; i < n; i++) {
+    const float x = pos(*rng);
+    const float y = pos(*rng);
+    seg->push_back(x);
+    seg->push_back(y);
+    seg->push_back(x + near(*rng));
+    seg->push_back(y + near(*rng));
+    seg->push_back(x + near(*rng));
+    seg->push_back(y + near(*rng));
+    seg->push_back(x + near(*rng));
+    seg->push_back(y + near(*rng));
+  }
+  std::shared_ptr<std::vector<float>> angles = std::make_shared<std::vector<float>>();
+  for (size_t i = 0; i < n; i++) {
+    angles->push_back(angle(*rng));
+  }
+
+  suite->Add("math/check_intersection", n, 0, [seg, n] {
+    const float *v = seg->data();
+    uint64_t hits = 0;
+    for (size_t i = 0; i < n; i++, v += 8) {
+      hits += Math::check_intersection(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7]);
+    }
+    sink_u = sink_u + hits;
+  });
+
+  suite->Add("math/dist_sq", n, 0, [seg, n] {
+    const float *v = seg->data();
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; i++, v += 8) {
+      sum += Math::dist_sq(v[0], v[1], v[2], v[3]);
+    }
+    sink_f = sum;
+  });
+
+  suite->Add("math/normalize_angle", n, 0, [angles, n] {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+      sum += Math::normalize_angle((*angles)[i]);
+    }
+    sink_f = sum;
+  });
+
+  // all lengths a snake goes through
+  std::shared_ptr<std::vector<std::shared_ptr<Snake>>> snakes =
+      std::make_shared<std::vector<std::shared_ptr<Snake>>>();
+  for (size_t len = 2; len <= WorldConfig::max_snake_parts; len += 8) {
+    snakes->push_back(MakeSnake(rng, static_cast<snake_id_t>(len), len));
+  }
+  suite->Add("snake/update_snake_consts", snakes->size(), 0, [snakes] {
+    float sum = 0.0f;
+    for (const std::shared_ptr<Snake> &s : *snakes) {
+      s->UpdateSnakeConsts();
+      sum += s->sc13;
+    }
+    sink_f = sum;
+  });
+}
+
+bool WriteJson(const std::string &path, const std::vector<Result> &results) {
+  FILE *f = fopen(path.c_str(), "w");
+  if (f == nullptr) {
+    return false;
+  }
+  fprintf(f, "{\n  \"benchmarks\": [\n");
+  for (size_t i = 0; i < results.size(); i++) {
+    fprintf(f, "    {\"name\": \"%s\", \"ns\": %.3f, \"bytes\": %zu}%s\n",
+            results[i].name.c_str(), results[i].ns, results[i].bytes,
+            i + 1 < results.size() ? "," : "");
+  }
+  fprintf(f, "  ]\n}\n");
+  return fclose(f) == 0;
+}
+
+// Reads the lines WriteJson writes.
+bool ReadJson(const std::string &path, std::map<std::string, double> *ns) {
+  FILE *f = fopen(path.c_str(), "r");
+  if (f == nullptr) {
+    return false;
+  }
+  char line[512];
+  char name[256];
+  double value;
+  while (fgets(line, sizeof(line), f) != nullptr) {
+    if (sscanf(line, " {\"name\": \"%255[^\"]\", \"ns\": %lf", name, &value) == 2) {
+      (*ns)[name] = value;
+    }
+  }
+  fclose(f);
+  return true;
+}
+
+// Returns the number of cases slower than the threshold.
+int Compare(const std::map<std::string, double> &base, const std::vector<Result> &results,
+            double threshold) {
+  int slower = 0;
+  printf("\n%-40s %12s %12s %8s\n", "case", "baseline ns", "ns", "change");
+  for (const Result &r : results) {
+    const auto b = base.find(r.name);
+    if (b == base.end()) {
+      printf("%-40s %12s %12.2f %8s\n", r.name.c_str(), "-", r.ns, "new");
+      continue;
+    }
+    const double change = (r.ns / b->second - 1.0) * 100.0;
+    const char *mark = "";
+    if (change > threshold) {
+      mark = "  SLOWER";
+      slower++;
+    } else if (change < -threshold) {
+      mark = "  faster";
+    }
+    printf("%-40s %12.2f %12.2f %+7.1f%%%s\n", r.name.c_str(), b->second, r.ns, change, mark);
+  }
+  return slower;
+}
+
+void Usage(FILE *out) {
+  fprintf(out,
+          "usage: bench_micro [--filter S] [--min-ms N] [--json out.json]\n"
+          "                   [--baseline base.json] [--threshold P]\n");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options o;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h") {
+      Usage(stdout);
+      return 0;
+    }
+    if (i + 1 >= argc) {
+      fprintf(stderr, "missing value for %s\n", arg.c_str());
+      Usage(stderr);
+      return 2;
+    }
+    const char *value = argv[++i];
+    if (arg == "--filter") {
+      o.filter = value;
+    } else if (arg == "--min-ms") {
+      o.min_ms = atof(value);
+    } else if (arg == "--json") {
+      o.json = value;
+    } else if (arg == "--baseline") {
+      o.baseline = value;
+    } else if (arg == "--threshold") {
+      o.threshold = atof(value);
+    } else {
+      fprintf(stderr, "unknown option %s\n", arg.c_str());
+      Usage(stderr);
+      return 2;
+    }
+  }
+
+  std::map<std::string, double> base;
+  if (!o.baseline.empty() && !ReadJson(o.baseline, &base)) {
+    fprintf(stderr, "cannot read %s\n", o.baseline.c_str());
+    return 2;
+  }
+
+  std::mt19937 rng(42);
+  Suite suite(o);
+  AddPacketCases(&suite, &rng);
+  AddMathCases(&suite, &rng);
+
+  if (!o.json.empty() && !WriteJson(o.json, suite.get_results())) {
+    fprintf(stderr, "cannot write %s\n", o.json.c_str());
+    return 2;
+  }
+  if (!o.baseline.empty() && Compare(base, suite.get_results(), o.threshold) > 0) {
+    return 1;
+  }
+  return 0;
+}
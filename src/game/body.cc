@@ -0,0 +1,158 @@
+#include "game/body.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+constexpr float BodyKernel::follow_tolerance;
+
+void BodyKernel::FollowTailScalar(float *nx, float *ny, const float *ox,
+                                  const float *oy, size_t begin, size_t end,
+                                  float k) {
+  for (size_t i = begin; i < end; ++i) {
+    const float px = ox[i - 1];
+    const float py = oy[i - 1];
+    nx[i] = px + k * (nx[i - 1] - px);
+    ny[i] = py + k * (ny[i - 1] - py);
+  }
+}
+
+#if defined(__SSE2__)
+// Inclusive scan of s[i] = a[i] + k * s[i - 1] over 4 lanes, seeded with
+// the previous block result in every lane of `carry`.
+static inline __m128 FollowScan4(__m128 a, __m128 k1, __m128 k2, __m128 kpow,
+                                 __m128 carry) {
+  __m128 s = _mm_add_ps(
+      a, _mm_mul_ps(k1, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(a), 4))));
+  s = _mm_add_ps(
+      s, _mm_mul_ps(k2, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(s), 8))));
+  return _mm_add_ps(s, _mm_mul_ps(kpow, carry));
+}
+#endif
+
+void BodyKernel::FollowTail(float *nx, float *ny, const float *ox,
+                            const float *oy, size_t begin, size_t end,
+                            float k) {
+  size_t i = begin;
+
+#if defined(__SSE2__)
+  // n[i] = (1 - k) * o[i - 1] + k * n[i - 1] is a first order linear
+  // recurrence, so each block of 4 is a prefix scan plus the carried in
+  // n[i - 1] scaled by k^1..k^4. x and y are two independent chains.
+  if (end >= begin + 4) {
+    const float k_2 = k * k;
+    const __m128 k1 = _mm_set1_ps(k);
+    const __m128 k2 = _mm_set1_ps(k_2);
+    const __m128 kpow = _mm_setr_ps(k, k_2, k_2 * k, k_2 * k_2);
+    const __m128 kinv = _mm_set1_ps(1.0f - k);
+
+    __m128 cx = _mm_set1_ps(nx[i - 1]);
+    __m128 cy = _mm_set1_ps(ny[i - 1]);
+
+    for (; i + 4 <= end; i += 4) {
+      const __m128 ax = _mm_mul_ps(kinv, _mm_loadu_ps(ox + i - 1));
+      const __m128 ay = _mm_mul_ps(kinv, _mm_loadu_ps(oy + i - 1));
+      const __m128 rx = FollowScan4(ax, k1, k2, kpow, cx);
+      const __m128 ry = FollowScan4(ay, k1, k2, kpow, cy);
+      _mm_storeu_ps(nx + i, rx);
+      _mm_storeu_ps(ny + i, ry);
+      cx = _mm_shuffle_ps(rx, rx, _MM_SHUFFLE(3, 3, 3, 3));
+      cy = _mm_shuffle_ps(ry, ry, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+  }
+#endif
+
+  FollowTailScalar(nx, ny, ox, oy, i, end, k);
+}
+
+void BodyKernel::SumScalar(const float *x, const float *y, size_t n,
+                           float *out_x, float *out_y) {
+  float sx = 0.0f;
+  float sy = 0.0f;
+  for (size_t i = 0; i < n; ++i) {
+    sx += x[i];
+    sy += y[i];
+  }
+  *out_x = sx;
+  *out_y = sy;
+}
+
+void BodyKernel::Sum(const float *x, const float *y, size_t n, float *out_x,
+                     float *out_y) {
+  size_t i = 0;
+  float sx = 0.0f;
+  float sy = 0.0f;
+
+#if defined(__AVX__)
+  if (n >= 8) {
+    __m256 vx = _mm256_setzero_ps();
+    __m256 vy = _mm256_setzero_ps();
+    for (; i + 8 <= n; i += 8) {
+      vx = _mm256_add_ps(vx, _mm256_loadu_ps(x + i));
+      vy = _mm256_add_ps(vy, _mm256_loadu_ps(y + i));
+    }
+    float lx[8], ly[8];
+    _mm256_storeu_ps(lx, vx);
+    _mm256_storeu_ps(ly, vy);
+    for (int l = 0; l < 8; ++l) {
+      sx += lx[l];
+      sy += ly[l];
+    }
+  }
+#elif defined(__SSE2__)
+  if (n >= 4) {
+    __m128 vx = _mm_setzero_ps();
+    __m128 vy = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) {
+      vx = _mm_add_ps(vx, _mm_loadu_ps(x + i));
+      vy = _mm_add_ps(vy, _mm_loadu_ps(y + i));
+    }
+    float lx[4], ly[4];
+    _mm_storeu_ps(lx, vx);
+    _mm_storeu_ps(ly, vy);
+    for (int l = 0; l < 4; ++l) {
+      sx += lx[l];
+      sy += ly[l];
+    }
+  }
+#endif
+
+  for (; i < n; ++i) {
+    sx += x[i];
+    sy += y[i];
+  }
+  *out_x = sx;
+  *out_y = sy;
+}
+
+void BodyKernel::ChunkBounds(const float *x, const float *y, size_t n,
+                             size_t chunk, BodyBound *out) {
+  for (size_t k = 0; k < n; k += chunk) {
+    const size_t end = std::min(k + chunk + 1, n);
+
+    // center of the chunk's axis aligned box, then the farthest part
+    float min_x = x[k], max_x = x[k];
+    float min_y = y[k], max_y = y[k];
+    for (size_t i = k + 1; i < end; ++i) {
+      min_x = std::min(min_x, x[i]);
+      max_x = std::max(max_x, x[i]);
+      min_y = std::min(min_y, y[i]);
+      max_y = std::max(max_y, y[i]);
+    }
+    const float cx = 0.5f * (min_x + max_x);
+    const float cy = 0.5f * (min_y + max_y);
+
+    float r_sq = 0.0f;
+    for (size_t i = k; i < end; ++i) {
+      const float dx = x[i] - cx;
+      const float dy = y[i] - cy;
+      r_sq = std::max(r_sq, dx * dx + dy * dy);
+    }
+    *out++ = BodyBound{cx, cy, sqrtf(r_sq)};
+  }
+}
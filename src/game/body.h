@@ -0,0 +1,136 @@
+#ifndef SRC_GAME_BODY_H_
+#define SRC_GAME_BODY_H_
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+struct Body {
+  float x; float y;
+  inline void From(const Body &p) { x = p.x; y = p.y; }
+  inline void Offset(float dx, float dy) { x += dx; y += dy; }
+  inline float DistanceSquared(float dx, float dy) const {
+    const float a = x - dx; const float b = y - dy; return a * a + b * b;
+  }
+};
+
+// Bounding circle of a chunk of consecutive body parts.
+struct BodyBound {
+  float x; float y; float r;
+};
+
+// Snake body parts, head first, stored as separate x and y arrays (SoA) so
+// the movement and collision kernels can stream them with SIMD loads.
+// Elements are read by value; writes go through set() or the raw arrays.
+class BodySeq {
+ public:
+  class const_iterator {
+   public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef Body value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef Body reference;
+
+    struct pointer {
+      Body b;
+      const Body *operator->() const { return &b; }
+    };
+
+    const_iterator() : seq(nullptr), i(0) {}
+    const_iterator(const BodySeq *in_seq, size_t in_i) : seq(in_seq), i(in_i) {}
+
+    Body operator*() const { return (*seq)[i]; }
+    pointer operator->() const { return {(*seq)[i]}; }
+    Body operator[](difference_type n) const { return (*seq)[i + n]; }
+
+    const_iterator &operator++() { ++i; return *this; }
+    const_iterator &operator--() { --i; return *this; }
+    const_iterator operator++(int) { const_iterator t = *this; ++i; return t; }
+    const_iterator operator--(int) { const_iterator t = *this; --i; return t; }
+    const_iterator &operator+=(difference_type n) { i += n; return *this; }
+    const_iterator &operator-=(difference_type n) { i -= n; return *this; }
+    const_iterator operator+(difference_type n) const { return {seq, i + n}; }
+    const_iterator operator-(difference_type n) const { return {seq, i - n}; }
+    difference_type operator-(const const_iterator &o) const {
+      return static_cast<difference_type>(i) - static_cast<difference_type>(o.i);
+    }
+
+    bool operator==(const const_iterator &o) const { return i == o.i; }
+    bool operator!=(const const_iterator &o) const { return i != o.i; }
+    bool operator<(const const_iterator &o) const { return i < o.i; }
+    bool operator>(const const_iterator &o) const { return i > o.i; }
+    bool operator<=(const const_iterator &o) const { return i <= o.i; }
+    bool operator>=(const const_iterator &o) const { return i >= o.i; }
+
+   private:
+    const BodySeq *seq;
+    size_t i;
+  };
+
+  inline size_t size() const { return xs.size(); }
+  inline bool empty() const { return xs.empty(); }
+  inline size_t capacity() const { return xs.capacity(); }
+  inline void reserve(size_t n) { xs.reserve(n); ys.reserve(n); }
+  inline void clear() { xs.clear(); ys.clear(); }
+
+  inline void push_back(const Body &b) { xs.push_back(b.x); ys.push_back(b.y); }
+  inline void pop_back() { xs.pop_back(); ys.pop_back(); }
+
+  inline Body operator[](size_t i) const { return {xs[i], ys[i]}; }
+  inline Body front() const { return {xs.front(), ys.front()}; }
+  inline Body back() const { return {xs.back(), ys.back()}; }
+  inline void set(size_t i, const Body &b) { xs[i] = b.x; ys[i] = b.y; }
+
+  inline float *x_data() { return xs.data(); }
+  inline float *y_data() { return ys.data(); }
+  inline const float *x_data() const { return xs.data(); }
+  inline const float *y_data() const { return ys.data(); }
+
+  const_iterator begin() const { return {this, 0}; }
+  const_iterator end() const { return {this, size()}; }
+
+ private:
+  std::vector<float> xs;
+  std::vector<float> ys;
+};
+
+typedef BodySeq::const_iterator BodySeqCIter;
+
+// Body movement kernels over SoA coordinates. Vectorized with SSE/AVX when
+// the target supports it, the *Scalar variants are the reference versions.
+class BodyKernel {
+  BodyKernel() = delete;
+
+ public:
+  // Tail follow step for parts [begin, end), begin >= 1:
+  //   n[i] = o[i - 1] + k * (n[i - 1] - o[i - 1])
+  // where o are the positions before the step and n after it. n[begin - 1]
+  // must already be updated.
+  //
+  // The SIMD version evaluates the recurrence as a 4-wide prefix scan, which
+  // reorders the float operations. Per part it stays within
+  // follow_tolerance world units of the scalar version.
+  static void FollowTail(float *nx, float *ny, const float *ox, const float *oy,
+                         size_t begin, size_t end, float k);
+  static void FollowTailScalar(float *nx, float *ny, const float *ox,
+                               const float *oy, size_t begin, size_t end,
+                               float k);
+
+  // Sums of the coordinates of n parts, for the bound box centroid.
+  static void Sum(const float *x, const float *y, size_t n, float *out_x,
+                  float *out_y);
+  static void SumScalar(const float *x, const float *y, size_t n, float *out_x,
+                        float *out_y);
+
+  // Bounding circles of the chunks of n parts starting every `chunk` parts.
+  // Each chunk also includes the first part of the next one, so the circle
+  // covers the segment joining them. Writes (n + chunk - 1) / chunk bounds.
+  static void ChunkBounds(const float *x, const float *y, size_t n,
+                          size_t chunk, BodyBound *out);
+
+  // A few float ulps at the map edge (coords up to 2 * game_radius), far
+  // below the 0.2 unit resolution of the wire format.
+  static constexpr float follow_tolerance = 1.0f / 32.0f;
+};
+
+#endif  // SRC_GAME_BODY_H_
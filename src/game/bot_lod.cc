@@ -0,0 +1,52 @@
+#include "game/bot_lod.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+void BotLod::Update(const std::vector<Snake *> &snakes, long dt) {
+  frames += static_cast<uint32_t>(dt / WorldConfig::frame_time_ms);
+  if (!stale && frames < refresh_frames) {
+    return;
+  }
+  frames = 0;
+  stale = false;
+
+  const int32_t edge = WorldConfig::sector_count_along_edge;
+  dist.assign(static_cast<size_t>(edge) * edge, stamp_sectors + 1);
+
+  for (const Snake *s : snakes) {
+    if (s->bot || (s->update & (change_dying | change_dead))) continue;
+
+    const int32_t hx = SectorSeq::get_coord(s->get_head_x());
+    const int32_t hy = SectorSeq::get_coord(s->get_head_y());
+    SectorSeq::ForEachIndexAround(hx, hy, stamp_sectors, [&](size_t index) {
+      const int32_t i = static_cast<int32_t>(index % edge);
+      const int32_t j = static_cast<int32_t>(index / edge);
+      const uint8_t d = static_cast<uint8_t>(std::max(std::abs(i - hx), std::abs(j - hy)));
+      dist[index] = std::min(dist[index], d);
+      return false;
+    });
+  }
+
+  std::fill(counts, counts + lod_count, 0);
+  for (Snake *s : snakes) {
+    if (!s->bot) continue;
+
+    const int32_t sx = std::min(edge - 1, std::max(0,
+        static_cast<int32_t>(s->sbb.x / WorldConfig::sector_size)));
+    const int32_t sy = std::min(edge - 1, std::max(0,
+        static_cast<int32_t>(s->sbb.y / WorldConfig::sector_size)));
+    const int32_t reach = static_cast<int32_t>(std::ceil(s->sbb.r / WorldConfig::sector_size));
+    const int32_t d = dist[sy * edge + sx] - reach;
+
+    s->lod = d <= full_sectors ? lod_full : (d <= near_sectors ? lod_near : lod_far);
+    counts[s->lod]++;
+  }
+}
+
+std::ostream &operator<<(std::ostream &out, const BotLod &l) {
+  return out << "bot lod: full = " << l.get_count(lod_full)
+             << ", near = " << l.get_count(lod_near)
+             << ", far = " << l.get_count(lod_far);
+}
@@ -0,0 +1,47 @@
+#ifndef SRC_GAME_BOT_LOD_H_
+#define SRC_GAME_BOT_LOD_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "game/config.h"
+#include "game/snake.h"
+
+// Picks the simulation detail of every bot from its distance to the nearest
+// human. Distances are kept per sector, in sectors (Chebyshev), stamped
+// around each human head, and a bot is as far as its body box allows: the
+// sector of the box center less the box radius.
+//
+// Tiers are refreshed every refresh_frames simulated frames, and on the
+// next update after a human joins. The full tier reaches a sector past the
+// human viewport, more than both snakes can close in between two refreshes,
+// so a bot is back at full detail before any part of it can be seen.
+class BotLod {
+ public:
+  // Refreshes the tiers of the bots in snakes when due, dt ms after the
+  // previous call.
+  void Update(const std::vector<Snake *> &snakes, long dt);
+  // Refreshes on the next Update, for a human that just joined.
+  void Invalidate() { stale = true; }
+
+  size_t get_count(bot_lod_t lod) const { return counts[lod]; }
+
+  static const uint32_t refresh_frames = 8;
+  static const int32_t full_sectors =
+      static_cast<int32_t>(Snake::view_radius / WorldConfig::sector_size) + 2;
+  static const int32_t near_sectors = 2 * full_sectors;
+  // stamp reach, farther sectors read as stamp_sectors + 1
+  static const int32_t stamp_sectors = near_sectors + 8;
+
+ private:
+  std::vector<uint8_t> dist;
+  uint32_t frames = 0;  // since the last refresh
+  bool stale = true;
+  size_t counts[lod_count] = {0, 0, 0};
+};
+
+std::ostream &operator<<(std::ostream &out, const BotLod &l);
+
+#endif  // SRC_GAME_BOT_LOD_H_
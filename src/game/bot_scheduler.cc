@@ -0,0 +1,121 @@
+#include "game/bot_scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+const size_t BotScheduler::batch_size;
+
+void BotScheduler::Add(Snake *s) {
+  if (!free_phases.empty()) {
+    s->ai_phase = free_phases.back();
+    free_phases.pop_back();
+  } else {
+    s->ai_phase = next_phase;
+    next_phase = (next_phase + phase_step) % Snake::get_ai_interval(lod_far);
+  }
+  s->ai_ticks = 0;
+  s->ai_queued = false;
+  bots.push_back(s);
+}
+
+long BotScheduler::SincePhase(const Snake *s) const {
+  const long interval = Snake::get_ai_interval(s->lod);
+  return ((clock - s->ai_phase) % interval + interval) % interval;
+}
+
+void BotScheduler::Remove(Snake *s) {
+  const auto it = std::find(bots.begin(), bots.end(), s);
+  if (it == bots.end()) {
+    return;
+  }
+  bots.erase(it);
+  free_phases.push_back(s->ai_phase);
+
+  if (s->ai_queued) {
+    due.erase(std::find(due.begin(), due.end(), s));
+    s->ai_queued = false;
+  }
+}
+
+void BotScheduler::Tick(long dt, SectorSeq *ss, const DangerGrid &danger, JobSystem *jobs) {
+  clock += dt;
+
+  // decisions due in dt on average, calls come every frame or two
+  float rate = 0.0f;
+  // due before dt passed, moved to a tier with a shorter interval
+  size_t promoted = 0;
+  for (Snake *s : bots) {
+    if (s->update & (change_dying | change_dead)) continue;
+
+    const long interval = Snake::get_ai_interval(s->lod);
+    rate += static_cast<float>(dt) / interval;
+    s->ai_ticks += dt;
+    if (s->ai_queued) continue;
+
+    if (SincePhase(s) < dt || s->ai_ticks > interval) {
+      s->ai_queued = true;
+      due.push_back(s);
+      promoted += s->ai_ticks - dt > interval;
+    }
+  }
+
+  // Over the average by a quarter or by three times the spread of a random
+  // count, whichever is more, so small bot counts absorb their bursts too
+  // and a backlog drains in a few calls.
+  const float headroom = std::max(rate * 0.25f, 3.0f * std::sqrt(rate));
+  const size_t share = static_cast<size_t>(rate + headroom) + 1 + promoted;
+  const size_t limit = std::min(due.size(), share);
+
+  const auto start = std::chrono::steady_clock::now();
+  batch.clear();
+  while (batch.size() < limit) {
+    if (time_budget_us > 0 && !batch.empty()) {
+      const auto spent = std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start);
+      if (spent.count() >= time_budget_us) break;
+    }
+
+    const size_t first = batch.size();
+    const size_t want = std::min(limit - first, batch_size);
+    while (batch.size() - first < want && !due.empty()) {
+      Snake *s = due.front();
+      due.pop_front();
+      if (s->update & (change_dying | change_dead)) {
+        s->ai_queued = false;
+        continue;
+      }
+      batch.push_back(s);
+    }
+    const size_t n = batch.size() - first;
+    if (n == 0) break;
+    decisions.resize(batch.size());
+
+    jobs->ParallelFor(n, job_grain, [this, first, ss, &danger](size_t begin, size_t end) {
+      for (size_t i = first + begin; i < first + end; i++) {
+        decisions[i] = batch[i]->TickAI(ss, danger);
+      }
+    });
+  }
+
+  for (size_t i = 0; i < batch.size(); i++) {
+    Snake *s = batch[i];
+    s->ApplyBotDecision(decisions[i]);
+    s->ai_ticks = 0;
+    s->ai_queued = false;
+  }
+
+  stats.decisions += batch.size();
+  stats.deferred += due.size();
+  stats.last_decisions = batch.size();
+  stats.backlog = due.size();
+}
+
+std::ostream &operator<<(std::ostream &out, const BotScheduler &b) {
+  const BotScheduler::Stats &st = b.get_stats();
+  return out << "bot ai: bots = " << b.size()
+             << ", decisions = " << st.decisions
+             << ", last frame = " << st.last_decisions
+             << ", backlog = " << st.backlog
+             << ", deferred = " << st.deferred;
+}
@@ -0,0 +1,72 @@
+#ifndef SRC_GAME_BOT_SCHEDULER_H_
+#define SRC_GAME_BOT_SCHEDULER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <vector>
+
+#include "game/danger_grid.h"
+#include "game/job_system.h"
+#include "game/sector.h"
+#include "game/snake.h"
+
+// Spreads bot AI over frames. Bots get evenly spaced AI phases as they are
+// added, so bots spawned together do not all think on the same frame. A bot
+// is due when the scheduler clock passes its phase, modulo the interval of
+// its tier, so the phases stay spread when bots change tiers. Due bots wait
+// in a queue, and each Tick takes a little over the average number of
+// decisions due in its dt from it; the rest stay queued for the next Tick.
+//
+// Decisions are made in batches on the worker threads against the state at
+// the start of the frame and applied together once all batches are done.
+// Without a time budget the results do not depend on the thread count.
+class BotScheduler {
+ public:
+  struct Stats {
+    uint64_t decisions = 0;  // total bot decisions made
+    uint64_t deferred = 0;   // total due bots left for a later frame
+    size_t last_decisions = 0;
+    size_t backlog = 0;      // bots queued after the last frame
+  };
+
+  void Add(Snake *s);
+  void Remove(Snake *s);
+
+  // Advances the AI clocks of all bots by dt and makes the due decisions.
+  void Tick(long dt, SectorSeq *ss, const DangerGrid &danger, JobSystem *jobs);
+
+  // Stops taking new batches once a frame has spent this long on AI,
+  // 0 for no limit. Makes the results depend on timing.
+  void set_time_budget_us(uint32_t us) { time_budget_us = us; }
+
+  size_t size() const { return bots.size(); }
+  const Stats &get_stats() const { return stats; }
+
+  // ~far tier AI interval / golden ratio, consecutive phases stay spread
+  // out over every tier's interval
+  static const long phase_step = 618;
+  static const size_t batch_size = 64;
+  static const size_t job_grain = 8;
+
+ private:
+  // Time since the clock last passed the bot's phase, modulo its tier's
+  // interval.
+  long SincePhase(const Snake *s) const;
+
+  std::vector<Snake *> bots;
+  std::deque<Snake *> due;
+  std::vector<Snake *> batch;
+  std::vector<Snake::BotDecision> decisions;
+  long clock = 0;  // ms
+  long next_phase = 0;
+  // phases of removed bots, new bots take them first to keep the spread
+  std::vector<long> free_phases;
+  uint32_t time_budget_us = 0;
+  Stats stats;
+};
+
+std::ostream &operator<<(std::ostream &out, const BotScheduler &b);
+
+#endif  // SRC_GAME_BOT_SCHEDULER_H_
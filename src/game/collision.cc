@@ -0,0 +1,157 @@
+#include "game/collision.h"
+
+#include "game/math.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+constexpr float Collision::parallel_epsilon;
+
+bool Collision::HeadHitsBodyScalar(const float *x, const float *y, size_t n,
+                                   float hx, float hy, float px, float py,
+                                   float hit_dist_sq) {
+  if (n == 0) {
+    return false;
+  }
+
+  for (size_t k = 0; k + 1 < n; ++k) {
+    if (Math::dist_sq(hx, hy, x[k], y[k]) < hit_dist_sq) {
+      return true;
+    }
+    if (Math::check_intersection(px, py, hx, hy, x[k], y[k], x[k + 1], y[k + 1])) {
+      return true;
+    }
+  }
+
+  return Math::dist_sq(hx, hy, x[n - 1], y[n - 1]) < hit_dist_sq;
+}
+
+bool Collision::HeadHitsBody(const float *x, const float *y, size_t n, float hx,
+                             float hy, float px, float py, float hit_dist_sq) {
+  if (n == 0) {
+    return false;
+  }
+
+  const float rx = hx - px;
+  const float ry = hy - py;
+  size_t k = 0;
+
+#if defined(__AVX__)
+  {
+    const __m256 v_hx = _mm256_set1_ps(hx);
+    const __m256 v_hy = _mm256_set1_ps(hy);
+    const __m256 v_px = _mm256_set1_ps(px);
+    const __m256 v_py = _mm256_set1_ps(py);
+    const __m256 v_rx = _mm256_set1_ps(rx);
+    const __m256 v_ry = _mm256_set1_ps(ry);
+    const __m256 v_hit = _mm256_set1_ps(hit_dist_sq);
+    const __m256 v_eps = _mm256_set1_ps(parallel_epsilon);
+    const __m256 v_zero = _mm256_setzero_ps();
+    const __m256 v_abs = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+
+    // segments k..k+7 read parts k..k+8
+    for (; k + 8 < n; k += 8) {
+      const __m256 cx = _mm256_loadu_ps(x + k);
+      const __m256 cy = _mm256_loadu_ps(y + k);
+      const __m256 dx = _mm256_loadu_ps(x + k + 1);
+      const __m256 dy = _mm256_loadu_ps(y + k + 1);
+
+      // head close to part k
+      const __m256 ex = _mm256_sub_ps(v_hx, cx);
+      const __m256 ey = _mm256_sub_ps(v_hy, cy);
+      const __m256 d2 = _mm256_add_ps(_mm256_mul_ps(ex, ex), _mm256_mul_ps(ey, ey));
+      __m256 hit = _mm256_cmp_ps(d2, v_hit, _CMP_LT_OQ);
+
+      // head step crosses segment k -> k+1
+      const __m256 sx = _mm256_sub_ps(dx, cx);
+      const __m256 sy = _mm256_sub_ps(dy, cy);
+      const __m256 det = _mm256_sub_ps(_mm256_mul_ps(v_rx, sy), _mm256_mul_ps(v_ry, sx));
+      const __m256 cax = _mm256_sub_ps(cx, v_px);
+      const __m256 cay = _mm256_sub_ps(cy, v_py);
+      const __m256 dax = _mm256_sub_ps(dx, v_px);
+      const __m256 day = _mm256_sub_ps(dy, v_py);
+      const __m256 o_c = _mm256_sub_ps(_mm256_mul_ps(v_rx, cay), _mm256_mul_ps(v_ry, cax));
+      const __m256 o_d = _mm256_sub_ps(_mm256_mul_ps(v_rx, day), _mm256_mul_ps(v_ry, dax));
+      // a - c = -(c - a), b - c = (b - a) - (c - a)
+      const __m256 bcx = _mm256_sub_ps(v_rx, cax);
+      const __m256 bcy = _mm256_sub_ps(v_ry, cay);
+      const __m256 o_a = _mm256_sub_ps(_mm256_mul_ps(sy, cax), _mm256_mul_ps(sx, cay));
+      const __m256 o_b = _mm256_sub_ps(_mm256_mul_ps(sx, bcy), _mm256_mul_ps(sy, bcx));
+
+      const __m256 cross = _mm256_and_ps(
+          _mm256_and_ps(_mm256_cmp_ps(_mm256_mul_ps(o_c, o_d), v_zero, _CMP_LE_OQ),
+                        _mm256_cmp_ps(_mm256_mul_ps(o_a, o_b), v_zero, _CMP_LE_OQ)),
+          _mm256_cmp_ps(_mm256_and_ps(det, v_abs), v_eps, _CMP_GE_OQ));
+      hit = _mm256_or_ps(hit, cross);
+
+      if (_mm256_movemask_ps(hit)) {
+        return true;
+      }
+    }
+  }
+#elif defined(__SSE2__)
+  {
+    const __m128 v_hx = _mm_set1_ps(hx);
+    const __m128 v_hy = _mm_set1_ps(hy);
+    const __m128 v_px = _mm_set1_ps(px);
+    const __m128 v_py = _mm_set1_ps(py);
+    const __m128 v_rx = _mm_set1_ps(rx);
+    const __m128 v_ry = _mm_set1_ps(ry);
+    const __m128 v_hit = _mm_set1_ps(hit_dist_sq);
+    const __m128 v_eps = _mm_set1_ps(parallel_epsilon);
+    const __m128 v_zero = _mm_setzero_ps();
+    const __m128 v_abs = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+    // segments k..k+3 read parts k..k+4
+    for (; k + 4 < n; k += 4) {
+      const __m128 cx = _mm_loadu_ps(x + k);
+      const __m128 cy = _mm_loadu_ps(y + k);
+      const __m128 dx = _mm_loadu_ps(x + k + 1);
+      const __m128 dy = _mm_loadu_ps(y + k + 1);
+
+      const __m128 ex = _mm_sub_ps(v_hx, cx);
+      const __m128 ey = _mm_sub_ps(v_hy, cy);
+      const __m128 d2 = _mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey));
+      __m128 hit = _mm_cmplt_ps(d2, v_hit);
+
+      const __m128 sx = _mm_sub_ps(dx, cx);
+      const __m128 sy = _mm_sub_ps(dy, cy);
+      const __m128 det = _mm_sub_ps(_mm_mul_ps(v_rx, sy), _mm_mul_ps(v_ry, sx));
+      const __m128 cax = _mm_sub_ps(cx, v_px);
+      const __m128 cay = _mm_sub_ps(cy, v_py);
+      const __m128 dax = _mm_sub_ps(dx, v_px);
+      const __m128 day = _mm_sub_ps(dy, v_py);
+      const __m128 o_c = _mm_sub_ps(_mm_mul_ps(v_rx, cay), _mm_mul_ps(v_ry, cax));
+      const __m128 o_d = _mm_sub_ps(_mm_mul_ps(v_rx, day), _mm_mul_ps(v_ry, dax));
+      const __m128 bcx = _mm_sub_ps(v_rx, cax);
+      const __m128 bcy = _mm_sub_ps(v_ry, cay);
+      const __m128 o_a = _mm_sub_ps(_mm_mul_ps(sy, cax), _mm_mul_ps(sx, cay));
+      const __m128 o_b = _mm_sub_ps(_mm_mul_ps(sx, bcy), _mm_mul_ps(sy, bcx));
+
+      const __m128 cross = _mm_and_ps(
+          _mm_and_ps(_mm_cmple_ps(_mm_mul_ps(o_c, o_d), v_zero),
+                     _mm_cmple_ps(_mm_mul_ps(o_a, o_b), v_zero)),
+          _mm_cmpge_ps(_mm_and_ps(det, v_abs), v_eps));
+      hit = _mm_or_ps(hit, cross);
+
+      if (_mm_movemask_ps(hit)) {
+        return true;
+      }
+    }
+  }
+#endif
+
+  for (; k + 1 < n; ++k) {
+    if (Math::dist_sq(hx, hy, x[k], y[k]) < hit_dist_sq) {
+      return true;
+    }
+    if (segments_cross(px, py, hx, hy, x[k], y[k], x[k + 1], y[k + 1])) {
+      return true;
+    }
+  }
+
+  return Math::dist_sq(hx, hy, x[n - 1], y[n - 1]) < hit_dist_sq;
+}
@@ -0,0 +1,48 @@
+#ifndef SRC_GAME_COLLISION_H_
+#define SRC_GAME_COLLISION_H_
+
+#include <cstddef>
+
+// Narrow-phase collision of a moving head against a snake body given as SoA
+// part coordinates (see BodySeq).
+class Collision {
+  Collision() = delete;
+
+ public:
+  // True if the head (hx, hy) is closer than sqrt(hit_dist_sq) to any of the
+  // n parts, or if the head step (px, py) -> (hx, hy) crosses any of the n - 1
+  // body segments.
+  //
+  // Segments are tested with division-free orientation signs, 8 (AVX) or 4
+  // (SSE) at a time, and the scan stops at the first block with a hit.
+  static bool HeadHitsBody(const float *x, const float *y, size_t n, float hx,
+                           float hy, float px, float py, float hit_dist_sq);
+
+  // Reference version built on Math::dist_sq and Math::check_intersection.
+  // Both agree except for touches within float rounding of a segment end.
+  static bool HeadHitsBodyScalar(const float *x, const float *y, size_t n,
+                                 float hx, float hy, float px, float py,
+                                 float hit_dist_sq);
+
+  // Scalar form of the SIMD lane test: segments a-b and c-d cross, and are
+  // not parallel.
+  static inline bool segments_cross(float ax, float ay, float bx, float by,
+                                    float cx, float cy, float dx, float dy) {
+    const float rx = bx - ax;
+    const float ry = by - ay;
+    const float sx = dx - cx;
+    const float sy = dy - cy;
+    const float det = rx * sy - ry * sx;
+    const float o_c = rx * (cy - ay) - ry * (cx - ax);
+    const float o_d = rx * (dy - ay) - ry * (dx - ax);
+    const float o_a = sx * (ay - cy) - sy * (ax - cx);
+    const float o_b = sx * (by - cy) - sy * (bx - cx);
+    return o_c * o_d <= 0.0f && o_a * o_b <= 0.0f &&
+           (det >= parallel_epsilon || det <= -parallel_epsilon);
+  }
+
+  // Same threshold as Math::check_intersection uses for its determinant.
+  static constexpr float parallel_epsilon = 0.0001f;
+};
+
+#endif  // SRC_GAME_COLLISION_H_
@@ -41,6 +41,27 @@ struct WorldConfig {
   uint16_t boost_cost = 20;
   uint8_t boost_drop_size = 10;
 
+  // Threads for the game tick, including the game loop thread. 1 runs
+  // everything on the loop thread. Results are the same for any count.
+  uint16_t sim_threads = 1;
+
+  // Time a frame may spend on bot AI in microseconds, bots over it think on
+  // a later frame. 0 only spreads bots evenly, which keeps results
+  // independent of timing.
+  uint32_t bot_ai_budget_us = 0;
+
+  // Simulate bots far from every human with less detail, see BotLod.
+  bool bot_lod = true;
+
+  // Seed of the world and simulation thread generators, 0 seeds from the
+  // clock. The same seed and inputs replay the same world.
+  uint64_t random_seed = 0;
+
+  // Deterministic mode for replay and build comparison: a fixed seed when
+  // random_seed is 0, one frame per Tick whatever its dt, no bot AI time
+  // budget, and a rolling state hash after every frame (World::GetFrameHash).
+  bool deterministic = false;
+
   // Original Slither.io values
   static const uint16_t game_radius = 21600;
   static const uint16_t max_snake_parts = 411;
@@ -0,0 +1,142 @@
+#include "game/danger_grid.h"
+
+#include "game/math.h"
+
+void DangerGrid::Init(float spawn_min_r, float spawn_max_r) {
+  const size_t cells = static_cast<size_t>(cells_along_edge) * cells_along_edge;
+  const int32_t edge = WorldConfig::sector_count_along_edge;
+  const size_t sectors = static_cast<size_t>(edge) * edge;
+
+  counts.assign(cells, 0);
+  key_sums.assign(cells, 0);
+  sector_counts.assign(sectors, 0);
+  in_ring.assign(sectors, false);
+  free_sectors.clear();
+  free_index.assign(sectors, -1);
+  filed.clear();
+
+  // the whole sector must be inside the ring
+  const float half_diag = WorldConfig::sector_diag_size / 2.0f;
+  const float center = WorldConfig::game_radius;
+  for (int32_t j = 0; j < edge; j++) {
+    for (int32_t i = 0; i < edge; i++) {
+      const float cx = (i + 0.5f) * WorldConfig::sector_size;
+      const float cy = (j + 0.5f) * WorldConfig::sector_size;
+      const float d = sqrtf(Math::dist_sq(cx, cy, center, center));
+      const uint32_t sector = j * edge + i;
+      in_ring[sector] = d - half_diag >= spawn_min_r && d + half_diag <= spawn_max_r;
+      SetFree(sector, in_ring[sector]);
+    }
+  }
+}
+
+void DangerGrid::Update(const Snake *s) {
+  if (counts.empty()) {
+    return;
+  }
+  if (filed.size() <= s->id) {
+    filed.resize(s->id + 1u);
+  }
+
+  // New cells are marked before the old ones are cleared, so cells the
+  // body still covers never drop to zero and touch their sector.
+  std::vector<uint32_t> &cells = stamped;
+  cells.clear();
+  const uint32_t key = get_key(s->id);
+  const float *px = s->parts.x_data();
+  const float *py = s->parts.y_data();
+  const size_t len = s->parts.size();
+  auto stamp = [&](size_t k) {
+    const uint32_t cell = cell_coord(py[k]) * cells_along_edge + cell_coord(px[k]);
+    // neighbouring parts mostly share a cell
+    if (!cells.empty() && cells.back() == cell) return;
+    cells.push_back(cell);
+    Mark(cell, key, 1);
+  };
+  for (size_t k = 0; k < len; k += part_stride) {
+    stamp(k);
+  }
+  if (len > 0 && (len - 1) % part_stride != 0) {
+    stamp(len - 1);
+  }
+
+  Remove(s);
+  filed[s->id].swap(stamped);
+}
+
+void DangerGrid::Remove(const Snake *s) {
+  if (filed.size() <= s->id) {
+    return;
+  }
+
+  std::vector<uint32_t> &cells = filed[s->id];
+  const uint32_t key = get_key(s->id);
+  for (uint32_t cell : cells) {
+    Mark(cell, key, -1);
+  }
+  cells.clear();
+}
+
+bool DangerGrid::FindDanger(float x, float y, snake_id_t self, float *out_x,
+                            float *out_y) const {
+  if (counts.empty()) {
+    return false;
+  }
+
+  const uint32_t key = get_key(self);
+  const int32_t cx = cell_coord(x);
+  const int32_t cy = cell_coord(y);
+  float best = -1.0f;
+  for (int32_t j = cy - 1; j <= cy + 1; j++) {
+    for (int32_t i = cx - 1; i <= cx + 1; i++) {
+      if (i < 0 || i >= cells_along_edge || j < 0 || j >= cells_along_edge) continue;
+
+      const uint32_t cell = j * cells_along_edge + i;
+      const uint32_t n = counts[cell];
+      if (n == 0 || key_sums[cell] == n * key) continue;
+
+      const float ox = (i + 0.5f) * cell_size;
+      const float oy = (j + 0.5f) * cell_size;
+      const float d = Math::dist_sq(x, y, ox, oy);
+      if (best < 0.0f || d < best) {
+        best = d;
+        *out_x = ox;
+        *out_y = oy;
+      }
+    }
+  }
+  return best >= 0.0f;
+}
+
+void DangerGrid::Reserve(uint32_t sector) { SetFree(sector, false); }
+
+void DangerGrid::Mark(uint32_t cell, uint32_t key, int32_t delta) {
+  const bool was_empty = counts[cell] == 0;
+  counts[cell] += delta;
+  key_sums[cell] += delta * key;
+  if (was_empty == (counts[cell] == 0)) {
+    return;
+  }
+
+  const int32_t cx = cell % cells_along_edge / cells_per_sector;
+  const int32_t cy = cell / cells_along_edge / cells_per_sector;
+  const uint32_t sector = cy * WorldConfig::sector_count_along_edge + cx;
+  sector_counts[sector] += was_empty ? 1 : -1;
+  if (in_ring[sector]) {
+    SetFree(sector, sector_counts[sector] == 0);
+  }
+}
+
+void DangerGrid::SetFree(uint32_t sector, bool free) {
+  const int32_t i = free_index[sector];
+  if (free && i < 0) {
+    free_index[sector] = static_cast<int32_t>(free_sectors.size());
+    free_sectors.push_back(sector);
+  } else if (!free && i >= 0) {
+    const uint32_t last = free_sectors.back();
+    free_sectors[i] = last;
+    free_index[last] = i;
+    free_sectors.pop_back();
+    free_index[sector] = -1;
+  }
+}
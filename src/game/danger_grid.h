@@ -0,0 +1,70 @@
+#ifndef SRC_GAME_DANGER_GRID_H_
+#define SRC_GAME_DANGER_GRID_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "game/config.h"
+#include "game/snake.h"
+
+// Low resolution occupancy of snake bodies, shared by bot avoidance and
+// spawn placement. Parts mark the cell they lie in; like SegmentGrid a snake
+// is restamped only on the frames it moves.
+//
+// A cell keeps how many runs of parts marked it and the sum of their owner
+// keys, so a query can tell "only my own body" from "someone else" without
+// a list of owners per cell.
+//
+// Sectors without any part whose center lies in the spawn ring are kept in
+// a free list, spawning draws from it instead of probing random points.
+class DangerGrid {
+ public:
+  // Sets the spawn ring, distances from the map center, and clears the grid.
+  void Init(float spawn_min_r, float spawn_max_r);
+
+  // (Re)stamps all parts of the snake.
+  void Update(const Snake *s);
+  void Remove(const Snake *s);
+
+  // Looks at the 3x3 cells around (x, y) for parts of a snake other than
+  // self. On a hit returns true and the center of the closest such cell.
+  bool FindDanger(float x, float y, snake_id_t self, float *out_x, float *out_y) const;
+
+  size_t get_free_count() const { return free_sectors.size(); }
+  // index in SectorSeq of the i-th free sector
+  uint32_t get_free_sector(size_t i) const { return free_sectors[i]; }
+  // Takes the sector out of the free list until a body leaves it again.
+  void Reserve(uint32_t sector);
+
+  static const uint16_t cell_size = WorldConfig::sector_size / 6;
+  // Every part_stride-th part and the tail are stamped, tail parts lie
+  // closer than a cell apart even so.
+  static const size_t part_stride = 3;
+  static const int32_t cells_per_sector = WorldConfig::sector_size / cell_size;
+  static const int32_t cells_along_edge =
+      WorldConfig::sector_count_along_edge * cells_per_sector;
+
+ private:
+  static inline uint32_t get_key(snake_id_t id) { return id * 2654435761u; }
+  static inline int32_t cell_coord(float v) {
+    const int32_t c = static_cast<int32_t>(v / cell_size);
+    return c < 0 ? 0 : (c >= cells_along_edge ? cells_along_edge - 1 : c);
+  }
+
+  void Mark(uint32_t cell, uint32_t key, int32_t delta);
+  void SetFree(uint32_t sector, bool free);
+
+  std::vector<uint16_t> counts;
+  std::vector<uint32_t> key_sums;
+  // non empty cells per sector, and whether the sector is in the spawn ring
+  std::vector<uint32_t> sector_counts;
+  std::vector<bool> in_ring;
+  std::vector<uint32_t> free_sectors;
+  std::vector<int32_t> free_index;  // in free_sectors, -1 if not free
+  // cells marked by each snake, by snake id
+  std::vector<std::vector<uint32_t>> filed;
+  std::vector<uint32_t> stamped;
+};
+
+#endif  // SRC_GAME_DANGER_GRID_H_
@@ -21,6 +21,5 @@ struct Food {
 };
 
 typedef std::vector<Food> FoodSeq;
-typedef std::vector<Food>::iterator FoodSeqIter;
 
 #endif  // SRC_GAME_FOOD_H_
@@ -0,0 +1,69 @@
+#include "game/food_regen.h"
+
+void FoodRegen::Init(SectorSeq *ss, float food_r) {
+  const size_t n = ss->size();
+  const float center = WorldConfig::game_radius;
+  tree.assign(n + 1, 0);
+  deficit.assign(n, 0);
+  regrows.assign(n, false);
+  total = 0;
+  top_step = 1;
+  while (top_step * 2 <= n) {
+    top_step *= 2;
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    const Sector &s = (*ss)[i];
+    regrows[i] = Math::dist_sq(s.box.x, s.box.y, center, center) <= food_r * food_r;
+    if (regrows[i] && s.food.size() < s.max_food_capacity) {
+      deficit[i] = static_cast<uint32_t>(s.max_food_capacity - s.food.size());
+    }
+    total += deficit[i];
+  }
+
+  // linear build, each node passes its sum on to its parent
+  for (size_t k = 1; k <= n; k++) {
+    tree[k] += deficit[k - 1];
+    const size_t parent = k + (k & (~k + 1));
+    if (parent <= n) {
+      tree[parent] += tree[k];
+    }
+  }
+
+  ss->TakeFoodChanges([](Sector &) {});
+}
+
+void FoodRegen::Sync(SectorSeq *ss) {
+  ss->TakeFoodChanges([this](const Sector &s) { Update(s); });
+}
+
+void FoodRegen::Update(const Sector &s) {
+  const size_t i = s.get_index();
+  uint32_t d = 0;
+  if (regrows[i] && s.food.size() < s.max_food_capacity) {
+    d = static_cast<uint32_t>(s.max_food_capacity - s.food.size());
+  }
+  if (d != deficit[i]) {
+    // unsigned wrap around subtracts
+    Add(i, d - deficit[i]);
+    total += d - deficit[i];
+    deficit[i] = d;
+  }
+}
+
+void FoodRegen::Add(size_t sector, uint32_t delta) {
+  for (size_t k = sector + 1; k < tree.size(); k += k & (~k + 1)) {
+    tree[k] += delta;
+  }
+}
+
+size_t FoodRegen::Find(uint32_t pick) const {
+  size_t pos = 0;
+  for (size_t step = top_step; step > 0; step >>= 1) {
+    if (pos + step < tree.size() && tree[pos + step] <= pick) {
+      pos += step;
+      pick -= tree[pos];
+    }
+  }
+  return pos;
+}
@@ -0,0 +1,41 @@
+#ifndef SRC_GAME_FOOD_REGEN_H_
+#define SRC_GAME_FOOD_REGEN_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "game/sector.h"
+
+// How much food each sector lacks to reach its max_food_capacity, kept in a
+// Fenwick tree. Regeneration draws a sector with probability proportional
+// to its deficit in O(log n), so no pellet is rolled for a full sector.
+//
+// Only sectors whose center lies inside the food radius regrow food. Sectors
+// are refreshed from SectorSeq::food_changes, so eating and dropped food
+// anywhere in the world are picked up by the next Sync.
+class FoodRegen {
+ public:
+  // Builds the deficits of all sectors and clears the change log.
+  void Init(SectorSeq *ss, float food_r);
+  // Refreshes the sectors whose food changed since the last call.
+  void Sync(SectorSeq *ss);
+  void Update(const Sector &s);
+
+  uint32_t get_total() const { return total; }
+  uint32_t get_deficit(size_t sector) const { return deficit[sector]; }
+  // Index of the sector holding unit `pick` of the deficit, in sector order.
+  // pick must be below get_total().
+  size_t Find(uint32_t pick) const;
+
+ private:
+  void Add(size_t sector, uint32_t delta);
+
+  std::vector<uint32_t> tree;  // 1 based
+  std::vector<uint32_t> deficit;
+  std::vector<bool> regrows;
+  uint32_t total = 0;
+  size_t top_step = 0;
+};
+
+#endif  // SRC_GAME_FOOD_REGEN_H_
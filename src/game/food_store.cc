@@ -0,0 +1,155 @@
+#include "game/food_store.h"
+
+static_assert(WorldConfig::sector_size % FoodStore::cells_along_edge == 0,
+              "food cells must tile the sector");
+
+void FoodStore::clear() {
+  xs.clear();
+  ys.clear();
+  sizes.clear();
+  colors.clear();
+  for (uint32_t &e : cell_end) {
+    e = 0;
+  }
+  gridded = false;
+}
+
+void FoodStore::Move(size_t to, size_t from) {
+  xs[to] = xs[from];
+  ys[to] = ys[from];
+  sizes[to] = sizes[from];
+  colors[to] = colors[from];
+}
+
+void FoodStore::BuildGrid() {
+  const size_t n = xs.size();
+  uint32_t next[cell_count] = {};
+  for (size_t k = 0; k < n; k++) {
+    cell_end[get_cell(xs[k], ys[k])]++;
+  }
+  for (uint32_t c = 1; c < cell_count; c++) {
+    cell_end[c] += cell_end[c - 1];
+  }
+  for (uint32_t c = 0; c < cell_count; c++) {
+    next[c] = cell_begin(c);
+  }
+
+  std::vector<uint16_t> new_xs(n);
+  std::vector<uint16_t> new_ys(n);
+  std::vector<uint8_t> new_sizes(n);
+  std::vector<uint8_t> new_colors(n);
+  for (size_t k = 0; k < n; k++) {
+    const uint32_t to = next[get_cell(xs[k], ys[k])]++;
+    new_xs[to] = xs[k];
+    new_ys[to] = ys[k];
+    new_sizes[to] = sizes[k];
+    new_colors[to] = colors[k];
+  }
+  xs.swap(new_xs);
+  ys.swap(new_ys);
+  sizes.swap(new_sizes);
+  colors.swap(new_colors);
+  gridded = true;
+}
+
+void FoodStore::Insert(Food f) {
+  if (!gridded) {
+    xs.push_back(f.x);
+    ys.push_back(f.y);
+    sizes.push_back(f.size);
+    colors.push_back(f.color);
+    if (xs.size() >= grid_min) {
+      BuildGrid();
+    }
+    return;
+  }
+
+  const uint32_t cell = get_cell(f.x, f.y);
+  uint32_t hole = static_cast<uint32_t>(xs.size());
+  xs.push_back(0);
+  ys.push_back(0);
+  sizes.push_back(0);
+  colors.push_back(0);
+
+  // every later cell hands its first item to the free slot past its end
+  for (uint32_t c = cell_count - 1; c > cell; c--) {
+    const uint32_t begin = cell_begin(c);
+    if (begin != hole) {
+      Move(hole, begin);
+      hole = begin;
+    }
+    cell_end[c]++;
+  }
+
+  xs[hole] = f.x;
+  ys[hole] = f.y;
+  sizes[hole] = f.size;
+  colors[hole] = f.color;
+  cell_end[cell]++;
+}
+
+void FoodStore::Remove(size_t i) {
+  if (!gridded) {
+    Move(i, xs.size() - 1);
+    xs.pop_back();
+    ys.pop_back();
+    sizes.pop_back();
+    colors.pop_back();
+    return;
+  }
+
+  const uint32_t cell = get_cell(xs[i], ys[i]);
+  uint32_t hole = cell_end[cell] - 1;
+  Move(i, hole);
+  cell_end[cell]--;
+
+  // every later cell fills the free slot before it with its last item
+  for (uint32_t c = cell + 1; c < cell_count; c++) {
+    const uint32_t last = cell_end[c] - 1;
+    if (last != hole) {
+      Move(hole, last);
+      hole = last;
+    }
+    cell_end[c]--;
+  }
+
+  xs.pop_back();
+  ys.pop_back();
+  sizes.pop_back();
+  colors.pop_back();
+
+  if (xs.size() < grid_min / 2) {
+    for (uint32_t &e : cell_end) {
+      e = 0;
+    }
+    gridded = false;
+  }
+}
+
+size_t FoodStore::Find(const Food &f) const {
+  const size_t n = xs.size();
+  if (!gridded) {
+    for (size_t k = 0; k < n; k++) {
+      if (xs[k] == f.x && ys[k] == f.y && sizes[k] == f.size && colors[k] == f.color) {
+        return k;
+      }
+    }
+    return n;
+  }
+  const uint32_t cell = get_cell(f.x, f.y);
+  const uint32_t end = cell_end[cell];
+  for (uint32_t k = cell_begin(cell); k < end; k++) {
+    if (xs[k] == f.x && ys[k] == f.y && sizes[k] == f.size && colors[k] == f.color) {
+      return k;
+    }
+  }
+  return n;
+}
+
+void FoodStore::CopyTo(FoodSeq *out) const {
+  out->clear();
+  out->reserve(xs.size());
+  for (size_t k = 0; k < xs.size(); k++) {
+    out->push_back((*this)[k]);
+  }
+}
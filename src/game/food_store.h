@@ -0,0 +1,125 @@
+#ifndef SRC_GAME_FOOD_STORE_H_
+#define SRC_GAME_FOOD_STORE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "game/config.h"
+#include "game/food.h"
+
+// Food of one sector, stored as separate coordinate, size and color arrays
+// (SoA) and grouped by a 4x4 sub-grid of the sector. Cells are laid out row
+// by row, so the cells a query circle overlaps in one row are a single
+// contiguous slice of the arrays.
+//
+// Insert appends to the cell's slice and Remove swaps the item with the last
+// one of its cell; the following cells are shifted by moving their first or
+// last item, so both touch at most cell_count items whatever the density.
+// Order inside a cell is not kept, indices are only valid until the next
+// Insert or Remove.
+//
+// Most sectors hold a few dozen items, where those moves cost more than the
+// grid saves. Below grid_min items the arrays are one unsorted slice with
+// plain append and swap-remove. The grid is built when the store reaches
+// grid_min and dropped when it falls under grid_min / 2.
+class FoodStore {
+ public:
+  static const uint16_t cells_along_edge = 4;
+  static const uint16_t cell_count = cells_along_edge * cells_along_edge;
+  static const uint16_t cell_size = WorldConfig::sector_size / cells_along_edge;
+  static const uint32_t grid_min = 64;
+
+  // Top left corner of the sector, food outside it goes to the edge cells.
+  void SetOrigin(uint16_t x, uint16_t y) { origin_x = x; origin_y = y; }
+
+  inline size_t size() const { return xs.size(); }
+  inline bool empty() const { return xs.empty(); }
+  void clear();
+
+  inline Food operator[](size_t i) const {
+    return Food{xs[i], ys[i], sizes[i], colors[i]};
+  }
+
+  void Insert(Food f);
+  void Remove(size_t i);
+  // Index of an item equal to f, or size() if there is none.
+  size_t Find(const Food &f) const;
+  void CopyTo(FoodSeq *out) const;
+
+  // f(const Food &) for the food closer than r to (x, y), stops early when f
+  // returns true. Returns whether it stopped early.
+  template <typename F>
+  bool ForEachInRadius(float x, float y, float r, F f) const;
+
+ private:
+  static inline int32_t clamp_cell(int32_t c) {
+    return c < 0 ? 0 : (c >= cells_along_edge ? cells_along_edge - 1 : c);
+  }
+  inline int32_t cell_coord(float v, uint16_t origin) const {
+    const float d = v - origin;
+    return clamp_cell(d < 0 ? -1 : static_cast<int32_t>(d / cell_size));
+  }
+  inline uint32_t get_cell(uint16_t x, uint16_t y) const {
+    return static_cast<uint32_t>(cell_coord(y, origin_y) * cells_along_edge +
+                                 cell_coord(x, origin_x));
+  }
+  inline uint32_t cell_begin(uint32_t c) const { return c == 0 ? 0 : cell_end[c - 1]; }
+  void Move(size_t to, size_t from);
+  // Sorts the items by cell and fills cell_end.
+  void BuildGrid();
+
+  uint16_t origin_x = 0;
+  uint16_t origin_y = 0;
+  // items of cell c are [cell_end[c - 1], cell_end[c])
+  uint32_t cell_end[cell_count] = {};
+  bool gridded = false;
+
+  std::vector<uint16_t> xs;
+  std::vector<uint16_t> ys;
+  std::vector<uint8_t> sizes;
+  std::vector<uint8_t> colors;
+};
+
+template <typename F>
+bool FoodStore::ForEachInRadius(float x, float y, float r, F f) const {
+  if (xs.empty()) {
+    return false;
+  }
+
+  const float r_sq = r * r;
+  const uint16_t *px = xs.data();
+  const uint16_t *py = ys.data();
+
+  if (!gridded) {
+    const uint32_t n = static_cast<uint32_t>(xs.size());
+    for (uint32_t k = 0; k < n; k++) {
+      const float dx = px[k] - x;
+      const float dy = py[k] - y;
+      if (dx * dx + dy * dy < r_sq && f((*this)[k])) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  const int32_t i0 = cell_coord(x - r, origin_x);
+  const int32_t i1 = cell_coord(x + r, origin_x);
+  const int32_t j0 = cell_coord(y - r, origin_y);
+  const int32_t j1 = cell_coord(y + r, origin_y);
+
+  for (int32_t j = j0; j <= j1; j++) {
+    const uint32_t row = static_cast<uint32_t>(j * cells_along_edge);
+    const uint32_t end = cell_end[row + i1];
+    for (uint32_t k = cell_begin(row + i0); k < end; k++) {
+      const float dx = px[k] - x;
+      const float dy = py[k] - y;
+      if (dx * dx + dy * dy < r_sq && f((*this)[k])) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+#endif  // SRC_GAME_FOOD_STORE_H_
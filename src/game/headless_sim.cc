@@ -0,0 +1,128 @@
+#include "game/headless_sim.h"
+
+#include <string>
+
+#include "game/math.h"
+
+HeadlessSim::HeadlessSim(const WorldConfig &in_config, uint16_t human_count)
+    : config(in_config), humans(human_count, 0), next_command(human_count, 0) {
+  world.Init(config);
+  script.Seed(world.GetSeed(), script_stream);
+  SpawnHumans();
+}
+
+void HeadlessSim::Replay(const SimInputLog &log) {
+  inputs = log;
+  inputs.Rewind();
+  replay = true;
+}
+
+void HeadlessSim::Step(long dt) {
+  const uint32_t frame = world.GetFrame();
+  SpawnHumans();
+  if (!replay) {
+    ScriptHumans(frame);
+  }
+  inputs.ForFrame(frame, [this](const SimInput &in) { world.ApplyInput(in); });
+
+  world.Tick(dt);
+
+  // GameServer::RespawnBots, one bot per frame
+  if (config.bot_respawn) {
+    size_t active_bots = 0;
+    for (const Snake *s : world.GetTickOrder()) {
+      active_bots += s->bot && !(s->update & (change_dying | change_dead));
+    }
+    if (active_bots < config.bots) {
+      world.AddSnake(world.CreateSnakeBot());
+    }
+  }
+
+  // GameServer::GrowSpawningSnakes
+  for (Snake *s : world.GetTickOrder()) {
+    if (s->parts.size() < s->target_score) {
+      s->IncreaseSnake(50);
+      s->update |= change_fullness | change_pos;
+    }
+  }
+
+  CollectUpdates();
+
+  // GameServer::RemoveDeadSnakes
+  for (snake_id_t id : world.GetDead()) {
+    world.RemoveSnake(id);
+    for (snake_id_t &h : humans) {
+      if (h == id) {
+        h = 0;
+      }
+    }
+  }
+  world.GetDead().clear();
+}
+
+void HeadlessSim::SpawnHumans() {
+  for (size_t i = 0; i < humans.size(); i++) {
+    if (humans[i] == 0) {
+      Snake::Ptr s = world.CreateSnake(config.h_snake_start_score);
+      s->name = "human " + std::to_string(i);
+      world.AddSnake(s);
+      humans[i] = s->id;
+    }
+  }
+}
+
+// A player wanders: turns up to 90 degrees either way and boosts now and
+// then, every 20 to 120 frames.
+void HeadlessSim::ScriptHumans(uint32_t frame) {
+  for (size_t i = 0; i < humans.size(); i++) {
+    if (frame < next_command[i]) {
+      continue;
+    }
+    next_command[i] = frame + 20 + script.Next(100);
+
+    const auto sn_i = world.GetSnake(humans[i]);
+    const float angle = sn_i->second->angle + (script.Nextf() - 0.5f) * Math::f_pi;
+    const SimInput steer = {frame, humans[i], sim_input_steer, Math::normalize_angle(angle)};
+    const SimInput boost = {frame, humans[i], sim_input_boost, script.Next(10) == 0 ? 1.0f : 0.0f};
+    inputs.Add(steer);
+    inputs.Add(boost);
+  }
+}
+
+// GameServer::CollectUpdates without the packets: dead snakes drop their
+// food, the flags sent to clients are cleared, player viewports are drained.
+void HeadlessSim::CollectUpdates() {
+  for (Snake *s : world.GetChangedSnakes()) {
+    const uint8_t flags = s->update;
+    if (flags & change_dead) {
+      continue;
+    }
+
+    if (flags & change_dying) {
+      s->on_dead_food_spawn(&world.GetSectors(), &world.GetRandom());
+      s->update |= change_dead;
+      world.GetDead().push_back(s->id);
+      continue;
+    }
+
+    if (flags & change_angle) {
+      s->update &= ~change_angle;
+      s->update &= ~(flags & change_wangle);
+    }
+    s->update &= ~(flags & change_speed);
+    if (flags & change_pos) {
+      s->update &= ~change_pos;
+      if (!s->bot) {
+        s->update &= ~(flags & change_fullness);
+        // GameServer::CollectPOVUpdate
+        for (const Sector *sec : s->vp.new_sectors) {
+          view_food += sec->food.size();
+        }
+        view_sectors += s->vp.new_sectors.size();
+        s->vp.new_sectors.clear();
+        s->vp.old_sectors.clear();
+      }
+    }
+  }
+  world.FlushChanges();
+}
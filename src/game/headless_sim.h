@@ -0,0 +1,61 @@
+#ifndef SRC_GAME_HEADLESS_SIM_H_
+#define SRC_GAME_HEADLESS_SIM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "game/random.h"
+#include "game/sim_input.h"
+#include "game/world.h"
+
+// Runs a World without the server: plays GameServer's part of a frame
+// (spawn growth, dead snakes dropping their food, clearing the sent update
+// flags, draining the viewport changes of players, bot respawn) and drives
+// scripted human players that steer and boost at random intervals.
+//
+// Scripted commands are recorded to get_inputs(); a run given a saved log
+// replays those commands instead of scripting new ones.
+class HeadlessSim {
+ public:
+  HeadlessSim(const WorldConfig &config, uint16_t humans);
+  HeadlessSim(const HeadlessSim &) = delete;
+  HeadlessSim &operator=(const HeadlessSim &) = delete;
+
+  // Replays `log` from the next frame on instead of scripting the humans.
+  void Replay(const SimInputLog &log);
+
+  // Runs one tick of dt ms, a frame by default. Deterministic worlds
+  // always step a frame.
+  void Step(long dt = WorldConfig::frame_time_ms);
+
+  World &get_world() { return world; }
+  const World &get_world() const { return world; }
+  const SimInputLog &get_inputs() const { return inputs; }
+  size_t get_human_count() const { return humans.size(); }
+  // Sectors that entered a player viewport and their pellets, which the
+  // server would have sent, since construction.
+  uint64_t get_view_sectors() const { return view_sectors; }
+  uint64_t get_view_food() const { return view_food; }
+
+ private:
+  void SpawnHumans();
+  void ScriptHumans(uint32_t frame);
+  void CollectUpdates();
+
+  WorldConfig config;
+  World world;
+  SimInputLog inputs;
+  bool replay = false;
+  // Separate stream, scripting never shifts the world's random sequence.
+  Random script;
+  // snake of each scripted player, 0 while it waits to respawn
+  std::vector<snake_id_t> humans;
+  std::vector<uint32_t> next_command;
+  uint64_t view_sectors = 0;
+  uint64_t view_food = 0;
+
+  static const uint64_t script_stream = 1000;
+};
+
+#endif  // SRC_GAME_HEADLESS_SIM_H_
@@ -0,0 +1,193 @@
+#include "game/job_system.h"
+
+#include <algorithm>
+#include <string>
+
+#include "game/trace.h"
+
+static thread_local size_t thread_index = 0;
+
+JobGraph::JobId JobGraph::Add(JobFn fn, std::initializer_list<JobId> deps) {
+  const JobId id = jobs.size();
+  jobs.emplace_back(new Job());
+  Job &job = *jobs.back();
+  job.fn = std::move(fn);
+  for (JobId dep : deps) {
+    jobs[dep]->next.push_back(id);
+    job.deps++;
+  }
+  return id;
+}
+
+void JobGraph::Clear() { jobs.clear(); }
+
+JobSystem::~JobSystem() { Stop(); }
+
+void JobSystem::Start(size_t count) {
+  Stop();
+
+  stopping = false;
+  queues.clear();
+  for (size_t i = 0; i < std::max<size_t>(count, 1); i++) {
+    queues.emplace_back(new Queue());
+  }
+  for (size_t i = 1; i < count; i++) {
+    workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+  }
+}
+
+void JobSystem::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+
+  for (std::thread &t : workers) {
+    t.join();
+  }
+  workers.clear();
+}
+
+void JobSystem::Run(JobGraph *graph) {
+  const size_t n = graph->jobs.size();
+  if (workers.empty()) {
+    for (auto &job : graph->jobs) {
+      job->fn();
+    }
+    return;
+  }
+
+  graph->left.store(n);
+  for (auto &job : graph->jobs) {
+    job->waiting.store(job->deps);
+  }
+  // the own deque pops newest first, push backwards to start in order
+  for (size_t i = n; i-- > 0;) {
+    if (graph->jobs[i]->deps == 0) {
+      Push(Task{nullptr, 0, 0, nullptr, graph, i, nullptr});
+    }
+  }
+  WakeWorkers();
+
+  HelpUntil(graph->left);
+}
+
+void JobSystem::ParallelFor(size_t n, size_t grain, const RangeFn &f) {
+  if (grain == 0) {
+    grain = 1;
+  }
+  if (workers.empty() || n <= grain) {
+    if (n > 0) {
+      f(0, n);
+    }
+    return;
+  }
+
+  const size_t blocks = (n + grain - 1) / grain;
+  std::atomic<size_t> left(blocks);
+  const char *trace_name = TraceScope::get_current();
+  for (size_t b = blocks; b-- > 0;) {
+    const size_t begin = b * grain;
+    Push(Task{&f, begin, std::min(begin + grain, n), &left, nullptr, 0, trace_name});
+  }
+  WakeWorkers();
+
+  HelpUntil(left);
+}
+
+size_t JobSystem::get_thread_index() { return thread_index; }
+
+void JobSystem::WorkerLoop(size_t index) {
+  thread_index = index;
+  Tracer::SetThreadName("worker " + std::to_string(index));
+
+  Task task;
+  for (;;) {
+    if (Pop(&task) || Steal(&task)) {
+      Execute(task);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    wake.wait(lock, [this] { return stopping || queued.load() > 0; });
+    if (stopping) {
+      return;
+    }
+  }
+}
+
+void JobSystem::Push(const Task &task) {
+  Queue &q = *queues[thread_index];
+  std::lock_guard<std::mutex> lock(q.mutex);
+  q.tasks.push_back(task);
+  queued++;
+}
+
+void JobSystem::WakeWorkers() {
+  // taking the lock orders this with a worker about to sleep
+  { std::lock_guard<std::mutex> lock(sleep_mutex); }
+  wake.notify_all();
+}
+
+bool JobSystem::Pop(Task *task) {
+  Queue &q = *queues[thread_index];
+  std::lock_guard<std::mutex> lock(q.mutex);
+  if (q.tasks.empty()) {
+    return false;
+  }
+  *task = q.tasks.back();
+  q.tasks.pop_back();
+  queued--;
+  return true;
+}
+
+bool JobSystem::Steal(Task *task) {
+  const size_t n = queues.size();
+  for (size_t i = 1; i < n; i++) {
+    Queue &q = *queues[(thread_index + i) % n];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (!q.tasks.empty()) {
+      *task = q.tasks.front();
+      q.tasks.pop_front();
+      queued--;
+      return true;
+    }
+  }
+  return false;
+}
+
+void JobSystem::Execute(const Task &task) {
+  if (task.graph == nullptr) {
+    TraceScope trace(task.trace_name);
+    (*task.fn)(task.begin, task.end);
+    task.blocks_left->fetch_sub(1);
+    return;
+  }
+
+  JobGraph::Job &job = *task.graph->jobs[task.job];
+  job.fn();
+
+  bool pushed = false;
+  for (auto i = job.next.rbegin(); i != job.next.rend(); ++i) {
+    if (--task.graph->jobs[*i]->waiting == 0) {
+      Push(Task{nullptr, 0, 0, nullptr, task.graph, *i, nullptr});
+      pushed = true;
+    }
+  }
+  if (pushed) {
+    WakeWorkers();
+  }
+  task.graph->left--;
+}
+
+void JobSystem::HelpUntil(const std::atomic<size_t> &left) {
+  Task task;
+  while (left.load() != 0) {
+    if (Pop(&task) || Steal(&task)) {
+      Execute(task);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
@@ -0,0 +1,110 @@
+#ifndef SRC_GAME_JOB_SYSTEM_H_
+#define SRC_GAME_JOB_SYSTEM_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Jobs in a dependency graph, run by JobSystem::Run. A job starts once all
+// the jobs it depends on are done. Dependencies can only name jobs added
+// earlier, so insertion order is always a valid serial order.
+class JobGraph {
+ public:
+  typedef size_t JobId;
+  typedef std::function<void()> JobFn;
+
+  JobId Add(JobFn fn, std::initializer_list<JobId> deps = {});
+  void Clear();
+
+  size_t size() const { return jobs.size(); }
+
+ private:
+  friend class JobSystem;
+
+  struct Job {
+    JobFn fn;
+    std::vector<JobId> next;
+    uint32_t deps = 0;
+    std::atomic<uint32_t> waiting{0};
+  };
+
+  std::vector<std::unique_ptr<Job>> jobs;
+  std::atomic<size_t> left{0};
+};
+
+// Work-stealing scheduler. Each thread keeps a deque of tasks: it pops the
+// newest of its own and steals the oldest from the others when it runs dry.
+// The thread calling Run or ParallelFor works on tasks until its own are
+// done, so a system of one thread runs everything inline, in order.
+class JobSystem {
+ public:
+  typedef std::function<void(size_t, size_t)> RangeFn;
+
+  JobSystem() = default;
+  JobSystem(const JobSystem &) = delete;
+  JobSystem &operator=(const JobSystem &) = delete;
+  ~JobSystem();
+
+  // Runs with `count` threads in total, the caller included.
+  void Start(size_t count);
+  void Stop();
+
+  // Runs all jobs of the graph and returns when they are done.
+  void Run(JobGraph *graph);
+
+  // Calls f(begin, end) on blocks of at most `grain` items covering [0, n)
+  // and returns when all of them are done. Blocks go to whichever thread is
+  // free, so f must not depend on the thread that runs it. May be called
+  // from inside a job.
+  void ParallelFor(size_t n, size_t grain, const RangeFn &f);
+
+  size_t get_thread_count() const { return workers.size() + 1; }
+  // Index of the calling thread in [0, get_thread_count()), 0 for the thread
+  // outside the system that calls Run. Meant for per-thread scratch space.
+  static size_t get_thread_index();
+
+ private:
+  struct Task {
+    const RangeFn *fn;  // a block of a ParallelFor, or
+    size_t begin;
+    size_t end;
+    std::atomic<size_t> *blocks_left;
+    JobGraph *graph;    // a job of a graph
+    JobGraph::JobId job;
+    const char *trace_name;  // span of the caller, for blocks
+  };
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void WorkerLoop(size_t index);
+  // Push adds to the calling thread's deque, WakeWorkers lets idle threads
+  // know there is something to steal.
+  void Push(const Task &task);
+  void WakeWorkers();
+  bool Pop(Task *task);
+  bool Steal(Task *task);
+  void Execute(const Task &task);
+  // Runs tasks until *left drops to zero.
+  void HelpUntil(const std::atomic<size_t> &left);
+
+  std::vector<std::thread> workers;
+  std::vector<std::unique_ptr<Queue>> queues;  // one per thread
+
+  std::mutex sleep_mutex;
+  std::condition_variable wake;
+  std::atomic<size_t> queued{0};
+  bool stopping = false;
+};
+
+#endif  // SRC_GAME_JOB_SYSTEM_H_
@@ -0,0 +1,55 @@
+#ifndef SRC_GAME_RANDOM_H_
+#define SRC_GAME_RANDOM_H_
+
+#include <cstdint>
+
+// PCG32 (O'Neill, pcg-random.org): 64 bit LCG state, 32 bit permuted output.
+// Generators with the same seed and different streams give independent
+// sequences. The world owns stream 0 and draws only on the loop thread; the
+// parallel phases draw nothing, as a stream per worker would make the
+// results depend on which worker ran a job.
+class Random {
+ public:
+  Random() { Seed(0, 0); }
+  Random(uint64_t seed, uint64_t stream) { Seed(seed, stream); }
+
+  void Seed(uint64_t seed, uint64_t stream) {
+    state = 0;
+    inc = (stream << 1u) | 1u;
+    Next();
+    state += seed;
+    Next();
+  }
+
+  inline uint32_t Next() {
+    const uint64_t old = state;
+    state = old * 6364136223846793005ull + inc;
+    const uint32_t xorshifted = static_cast<uint32_t>(((old >> 18u) ^ old) >> 27u);
+    const uint32_t rot = static_cast<uint32_t>(old >> 59u);
+    return (xorshifted >> rot) | (xorshifted << ((~rot + 1u) & 31u));
+  }
+
+  // Uniform in [0, bound) without modulo bias (Lemire's multiply and
+  // reject). bound 0 returns 0.
+  inline uint32_t Next(uint32_t bound) {
+    uint64_t m = static_cast<uint64_t>(Next()) * bound;
+    uint32_t low = static_cast<uint32_t>(m);
+    if (low < bound) {
+      const uint32_t threshold = (0u - bound) % bound;
+      while (low < threshold) {
+        m = static_cast<uint64_t>(Next()) * bound;
+        low = static_cast<uint32_t>(m);
+      }
+    }
+    return static_cast<uint32_t>(m >> 32);
+  }
+
+  // Uniform in [0, 1).
+  inline float Nextf() { return (Next() >> 8) * (1.0f / 16777216.0f); }
+
+ private:
+  uint64_t state;
+  uint64_t inc;
+};
+
+#endif  // SRC_GAME_RANDOM_H_
@@ -2,6 +2,22 @@
 
 #include <algorithm>
 
+void BoundBox::Reset(BoundBoxPos in_pos, snake_id_t in_id, const Snake *in_snake) {
+  x = in_pos.x;
+  y = in_pos.y;
+  r = in_pos.r;
+  id = in_id;
+  snake = in_snake;
+  sectors.clear();
+}
+
+void BoundBox::Unregister() {
+  for (Sector *s : sectors) {
+    s->RemoveSnake(id);
+  }
+  sectors.clear();
+}
+
 void BoundBox::Insert(Sector *s) {
   auto fwd_i = std::lower_bound(sectors.begin(), sectors.end(), s);
   if (fwd_i != sectors.end()) {
@@ -51,30 +67,15 @@ void Sector::RemoveSnake(snake_id_t id) {
 }
 
 void Sector::Insert(Food f) {
-  auto fwd_i = std::lower_bound(
-      food.begin(), food.end(), f,
-      [](const Food &a, const Food &b) { return a.x < b.x; });
-
-  if (fwd_i != food.end()) {
-    food.insert(fwd_i, f);
-  } else {
-    food.push_back(f);
-  }
-}
-
-void Sector::Remove(const FoodSeqIter &i) {
-  food.erase(i);
+  food_value += get_food_value(f);
+  food.Insert(f);
+  LogFoodChange();
 }
 
-void Sector::Sort() {
-  std::sort(food.begin(), food.end(),
-            [](const Food &a, const Food &b) { return a.x < b.x; });
-}
-
-FoodSeqIter Sector::FindClosestFood(uint16_t fx) {
-  return std::lower_bound(
-      food.begin(), food.end(), Food{fx, 0, 0, 0},
-      [](const Food &a, const Food &b) { return a.x < b.x; });
+void Sector::Remove(size_t i) {
+  food_value -= get_food_value(food[i]);
+  food.Remove(i);
+  LogFoodChange();
 }
 
 void SectorSeq::InitSectors() {
@@ -86,6 +87,9 @@ void SectorSeq::InitSectors() {
         static_cast<uint8_t>(i % WorldConfig::sector_count_along_edge),
         static_cast<uint8_t>(i / WorldConfig::sector_count_along_edge)});
   }
+  for (Sector &s : *this) {
+    s.food_log = &food_changes;
+  }
 }
 
 size_t SectorSeq::get_index(const uint16_t x, const uint16_t y) {
@@ -96,11 +100,37 @@ Sector *SectorSeq::get_sector(const uint16_t x, const uint16_t y) {
   return &operator[](get_index(x, y));
 }
 
+void SectorSeq::FindNearestFood(float x, float y, float r, size_t k,
+                                std::vector<Food> *out) const {
+  static thread_local std::vector<std::pair<float, Food>> found;
+  found.clear();
+  ForEachFoodInRadius(x, y, r, [&](size_t, const Food &f) {
+    found.push_back({Math::dist_sq(x, y, f.x, f.y), f});
+    return false;
+  });
+
+  const size_t n = std::min(k, found.size());
+  std::partial_sort(found.begin(), found.begin() + n, found.end(),
+                    [](const std::pair<float, Food> &a, const std::pair<float, Food> &b) {
+                      return a.first < b.first;
+                    });
+  out->clear();
+  for (size_t i = 0; i < n; i++) {
+    out->push_back(found[i].second);
+  }
+}
+
 void SnakeBoundBox::InsertSortedWithReg(Sector *s) {
   Insert(s);
   s->snakes.push_back(this);
 }
 
+void ViewPort::Reset(BoundBoxPos in_pos, snake_id_t in_id, const Snake *in_snake) {
+  BoundBox::Reset(in_pos, in_id, in_snake);
+  new_sectors.clear();
+  old_sectors.clear();
+}
+
 void ViewPort::RegNewSectorIfMissing(Sector *s) {
   if (std::find(new_sectors.begin(), new_sectors.end(), s) == new_sectors.end()) {
     new_sectors.push_back(s);
@@ -130,19 +160,12 @@ void SnakeBoundBox::UpdateBoxNewSectors(SectorSeq *ss, const float bb_r,
   }
 
   const BoundBoxPos box = {new_x, new_y, bb_r};
-  static const int16_t map_width_sectors =
-      static_cast<int16_t>(WorldConfig::sector_count_along_edge);
-
-  for (int j = new_sy - 1; j <= new_sy + 1; j++) {
-    for (int i = new_sx - 1; i <= new_sx + 1; i++) {
-      if (i >= 0 && i < map_width_sectors && j >= 0 && j < map_width_sectors) {
-        Sector *new_sector = ss->get_sector(i, j);
-        if (!IsPresent(new_sector) && new_sector->Intersect(box)) {
-          InsertSortedWithReg(new_sector);
-        }
-      }
+  ss->ForEachSectorAround(new_sx, new_sy, 1, [&](Sector &new_sector) {
+    if (!IsPresent(&new_sector) && new_sector.Intersect(box)) {
+      InsertSortedWithReg(&new_sector);
     }
-  }
+    return false;
+  });
 }
 
 void SnakeBoundBox::UpdateBoxOldSectors() {
@@ -179,19 +202,12 @@ void ViewPort::UpdateBoxNewSectors(SectorSeq *ss,
     return;
   }
 
-  static const int16_t map_width_sectors =
-      static_cast<int16_t>(WorldConfig::sector_count_along_edge);
-
-  for (int j = new_sy - 3; j <= new_sy + 3; j++) {
-    for (int i = new_sx - 3; i <= new_sx + 3; i++) {
-      if (i >= 0 && i < map_width_sectors && j >= 0 && j < map_width_sectors) {
-        Sector *new_sector = ss->get_sector(i, j);
-        if (!IsPresent(new_sector) && new_sector->Intersect(*this)) {
-          InsertSortedWithDelta(new_sector);
-        }
-      }
+  ss->ForEachSectorAround(new_sx, new_sy, 3, [&](Sector &new_sector) {
+    if (!IsPresent(&new_sector) && new_sector.Intersect(*this)) {
+      InsertSortedWithDelta(&new_sector);
     }
-  }
+    return false;
+  });
 }
 
 void ViewPort::UpdateBoxOldSectors() {
@@ -1,6 +1,7 @@
 #ifndef SRC_GAME_SECTOR_H_
 #define SRC_GAME_SECTOR_H_
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
@@ -8,6 +9,7 @@
 
 #include "game/config.h"
 #include "game/food.h"
+#include "game/food_store.h"
 #include "game/math.h"
 
 class Snake;
@@ -46,6 +48,11 @@ class BoundBox : public BoundBoxPos {
   BoundBox(BoundBoxPos in_pos, uint16_t in_id, const Snake *in_snake, SectorVec in_sectors)
       : BoundBoxPos(in_pos), id(in_id), snake(in_snake), sectors(in_sectors) {}
 
+  // Re-targets the box at a new owner, keeping the sectors storage.
+  // Sector registrations are not touched, see Unregister().
+  void Reset(BoundBoxPos in_pos, snake_id_t in_id, const Snake *in_snake);
+  void Unregister();
+
   void Insert(Sector *s);
   bool RemoveUnsorted(const SectorIter &i);
   bool IsPresent(const Sector *s);
@@ -61,10 +68,17 @@ class Sector {
   uint8_t y;
 
   uint16_t max_food_capacity = 0; 
+  // Sum of get_food_value over the food here, kept by Insert and Remove.
+  // Bots rank sectors by it before looking at single pellets.
+  uint32_t food_value = 0;
+  // Insert and Remove add the sector to this log once until it is taken,
+  // see SectorSeq::food_changes.
+  std::vector<uint32_t> *food_log = nullptr;
+  bool food_logged = false;
 
   BoundBoxPos box;
   BoundBoxVec snakes;
-  FoodSeq food;
+  FoodStore food;
 
   Sector(uint8_t in_x, uint8_t in_y) : x(in_x), y(in_y) {
     static const uint16_t half = WorldConfig::sector_size / 2;
@@ -72,6 +86,7 @@ class Sector {
 
     box = {1.0f * (WorldConfig::sector_size * x + half),
            1.0f * (WorldConfig::sector_size * y + half), r};
+    food.SetOrigin(WorldConfig::sector_size * x, WorldConfig::sector_size * y);
   }
 
   inline bool Intersect(const BoundBoxPos &box2) const {
@@ -79,23 +94,170 @@ class Sector {
   }
 
   void Insert(Food f);
-  void Remove(const FoodSeqIter &i);
-  FoodSeqIter FindClosestFood(uint16_t fx);
-  void Sort();
+  void Remove(size_t i);
+  static inline uint32_t get_food_value(const Food &f) { return f.size * f.size; }
+  inline uint32_t get_index() const {
+    return static_cast<uint32_t>(y) * WorldConfig::sector_count_along_edge + x;
+  }
+  inline void LogFoodChange() {
+    if (food_log != nullptr && !food_logged) {
+      food_logged = true;
+      food_log->push_back(get_index());
+    }
+  }
 
   void RemoveSnake(snake_id_t id);
 };
 
+// Spatial queries live here so every scan shares one clamped traversal.
+// Visitors are template parameters and inline into the callers; a visitor
+// returns true to stop early, and the query then returns true.
 class SectorSeq : public std::vector<Sector> {
  public:
   SectorSeq() : std::vector<Sector>() {}
 
   void InitSectors();
 
+  // Indices of the sectors whose food changed since the last
+  // TakeFoodChanges, each once.
+  std::vector<uint32_t> food_changes;
+  template <typename F>
+  void TakeFoodChanges(F f);
+
   size_t get_index(const uint16_t x, const uint16_t y);
   Sector *get_sector(const uint16_t x, const uint16_t y);
+
+  // Sector coordinate of a map coordinate, may be off the map. Rounds down,
+  // so -0.5 is in column -1 and not 0.
+  static inline int32_t get_coord(float v) {
+    return static_cast<int32_t>(floorf(v / WorldConfig::sector_size));
+  }
+
+  // f(size_t index) for the sectors on the map in the rows and columns
+  // [sx0, sx1] x [sy0, sy1], row by row.
+  template <typename F>
+  static bool ForEachIndexIn(int32_t sx0, int32_t sy0, int32_t sx1, int32_t sy1, F f);
+  // f(size_t index) for the sectors within r sectors of (sx, sy).
+  template <typename F>
+  static bool ForEachIndexAround(int32_t sx, int32_t sy, int32_t r, F f) {
+    return ForEachIndexIn(sx - r, sy - r, sx + r, sy + r, f);
+  }
+  // f(size_t index) for the sectors the segment a -> b passes, from a on.
+  template <typename F>
+  static bool ForEachIndexOnSegment(float ax, float ay, float bx, float by, F f);
+
+  // f(Sector &) for the sectors within r sectors of (sx, sy).
+  template <typename F>
+  bool ForEachSectorAround(int32_t sx, int32_t sy, int32_t r, F f) {
+    return ForEachIndexAround(sx, sy, r, [&](size_t i) { return f((*this)[i]); });
+  }
+
+  // f(size_t index, const Food &) for the food closer than r to (x, y).
+  // Only the food cells of each sector in reach are read.
+  template <typename F>
+  bool ForEachFoodInRadius(float x, float y, float r, F f) const;
+  // f(const BoundBox *) for the snake boxes overlapping the circle. A box
+  // registered in several sectors in reach is visited once per sector.
+  // (x, y) must be on the map, boxes are only registered in sectors on it.
+  template <typename F>
+  bool ForEachSnakeInRadius(float x, float y, float r, F f) const;
+  // Up to k food items closest to (x, y) within r, closest first.
+  void FindNearestFood(float x, float y, float r, size_t k, std::vector<Food> *out) const;
 };
 
+template <typename F>
+bool SectorSeq::ForEachIndexIn(int32_t sx0, int32_t sy0, int32_t sx1, int32_t sy1, F f) {
+  const int32_t last = WorldConfig::sector_count_along_edge - 1;
+  sx0 = sx0 < 0 ? 0 : sx0;
+  sy0 = sy0 < 0 ? 0 : sy0;
+  sx1 = sx1 > last ? last : sx1;
+  sy1 = sy1 > last ? last : sy1;
+  for (int32_t j = sy0; j <= sy1; j++) {
+    for (int32_t i = sx0; i <= sx1; i++) {
+      if (f(static_cast<size_t>(j) * WorldConfig::sector_count_along_edge + i)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// Walks the grid cell by cell (Amanatides & Woo), skipping the parts of the
+// segment off the map.
+template <typename F>
+bool SectorSeq::ForEachIndexOnSegment(float ax, float ay, float bx, float by, F f) {
+  const int32_t edge = WorldConfig::sector_count_along_edge;
+  const float size = WorldConfig::sector_size;
+  int32_t sx = get_coord(ax);
+  int32_t sy = get_coord(ay);
+  const int32_t ex = get_coord(bx);
+  const int32_t ey = get_coord(by);
+  const float dx = bx - ax;
+  const float dy = by - ay;
+  const int32_t step_x = dx > 0 ? 1 : -1;
+  const int32_t step_y = dy > 0 ? 1 : -1;
+  // segment fraction to the next column / row edge, and per column / row
+  const float inf = 1e30f;
+  const float delta_x = dx != 0 ? fabsf(size / dx) : inf;
+  const float delta_y = dy != 0 ? fabsf(size / dy) : inf;
+  float next_x = dx != 0 ? ((sx + (step_x > 0 ? 1 : 0)) * size - ax) / dx : inf;
+  float next_y = dy != 0 ? ((sy + (step_y > 0 ? 1 : 0)) * size - ay) / dy : inf;
+
+  for (;;) {
+    if (sx >= 0 && sx < edge && sy >= 0 && sy < edge &&
+        f(static_cast<size_t>(sy) * edge + sx)) {
+      return true;
+    }
+    if (sx == ex && sy == ey) {
+      return false;
+    }
+    if (next_x < next_y) {
+      if (next_x > 1.0f) return false;
+      sx += step_x;
+      next_x += delta_x;
+    } else {
+      if (next_y > 1.0f) return false;
+      sy += step_y;
+      next_y += delta_y;
+    }
+  }
+}
+
+template <typename F>
+bool SectorSeq::ForEachFoodInRadius(float x, float y, float r, F f) const {
+  return ForEachIndexIn(get_coord(x - r), get_coord(y - r), get_coord(x + r), get_coord(y + r),
+                        [&](size_t index) {
+    return (*this)[index].food.ForEachInRadius(x, y, r, [&](const Food &food) {
+      return f(index, food);
+    });
+  });
+}
+
+// f(Sector &) for each logged sector, then clears the log.
+template <typename F>
+void SectorSeq::TakeFoodChanges(F f) {
+  for (uint32_t index : food_changes) {
+    Sector &s = (*this)[index];
+    s.food_logged = false;
+    f(s);
+  }
+  food_changes.clear();
+}
+
+template <typename F>
+bool SectorSeq::ForEachSnakeInRadius(float x, float y, float r, F f) const {
+  const BoundBoxPos area = {x, y, r};
+  return ForEachIndexIn(get_coord(x - r), get_coord(y - r), get_coord(x + r), get_coord(y + r),
+                        [&](size_t index) {
+    for (const BoundBox *bb : (*this)[index].snakes) {
+      if (bb->Intersect(area) && f(bb)) {
+        return true;
+      }
+    }
+    return false;
+  });
+}
+
 class SnakeBoundBox : public BoundBox {
  public:
   SnakeBoundBox() = default;
@@ -125,6 +287,8 @@ class ViewPort : public BoundBox {
 
   explicit ViewPort(BoundBox in) : BoundBox({in.x, in.y, in.r}, in.id, in.snake, in.sectors) {}
 
+  void Reset(BoundBoxPos in_pos, snake_id_t in_id, const Snake *in_snake);
+
   void RegNewSectorIfMissing(Sector *s);
   void RegOldSectorIfMissing(Sector *s);
 
@@ -0,0 +1,55 @@
+#include "game/segment_grid.h"
+
+#include <algorithm>
+
+// A head reaches two max size body radii (2 * 29 * 6 / 2) plus one step past
+// a segment, and a chunk spans half its parts (at most move_step_distance
+// apart) either side of the middle one.
+static_assert(2 * 87 + WorldConfig::move_step_distance +
+                  SegmentGrid::chunk_parts / 2 * WorldConfig::move_step_distance <
+              WorldConfig::sector_size,
+              "segment grid sectors must cover the collision reach");
+
+void SegmentGrid::Update(const Snake *s) {
+  if (sectors.empty()) {
+    sectors.resize(static_cast<size_t>(WorldConfig::sector_count_along_edge) *
+                   WorldConfig::sector_count_along_edge);
+  }
+  if (filed.size() <= s->id) {
+    filed.resize(s->id + 1u);
+  }
+
+  Remove(s);
+
+  std::vector<uint32_t> &snake_sectors = filed[s->id];
+  const float *px = s->parts.x_data();
+  const float *py = s->parts.y_data();
+  const uint32_t len = static_cast<uint32_t>(s->parts.size());
+
+  for (uint32_t k = 0; k < len; k += chunk_parts) {
+    const uint32_t n = std::min(chunk_parts + 1, len - k);
+    const uint32_t mid = k + n / 2;
+    const uint32_t sector = get_sector(px[mid], py[mid]);
+    sectors[sector].push_back(Entry{s, k});
+
+    // neighbouring chunks mostly share a sector
+    if (snake_sectors.empty() || snake_sectors.back() != sector) {
+      snake_sectors.push_back(sector);
+    }
+  }
+}
+
+void SegmentGrid::Remove(const Snake *s) {
+  if (filed.size() <= s->id) {
+    return;
+  }
+
+  std::vector<uint32_t> &snake_sectors = filed[s->id];
+  for (uint32_t sector : snake_sectors) {
+    std::vector<Entry> &entries = sectors[sector];
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [s](const Entry &e) { return e.owner == s; }),
+                  entries.end());
+  }
+  snake_sectors.clear();
+}
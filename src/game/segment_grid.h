@@ -0,0 +1,92 @@
+#ifndef SRC_GAME_SEGMENT_GRID_H_
+#define SRC_GAME_SEGMENT_GRID_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "game/config.h"
+#include "game/snake.h"
+
+// Per-sector index of snake body segments. Bodies are cut into chunks of
+// chunk_parts segments, and each chunk is filed under the sector of its
+// middle part. Everything a head can touch is then in the 3x3 sectors around
+// it, so collision only tests local segments instead of whole bodies.
+//
+// The index is updated incrementally: a snake is refiled only on the frames
+// it moves. Entries keep the owner and first part index, the coordinates are
+// read from Snake::parts at query time, so growth or a reallocated body never
+// leaves a stale pointer behind.
+class SegmentGrid {
+ public:
+  struct Chunk {
+    const Snake *owner;
+    const float *x;
+    const float *y;
+    uint32_t n;  // points, chunk_parts + 1 except at the tail
+    float r;     // owner body part radius, lsz / 2
+    const BodyBound *bound;  // nullptr if the body grew since it moved
+  };
+
+  // (Re)files all chunks of the snake.
+  void Update(const Snake *s);
+  void Remove(const Snake *s);
+
+  // Calls f(const Chunk &) for the chunks in the sectors around (x, y), stops
+  // early when f returns true. Returns whether it stopped early.
+  template <typename F>
+  bool ForEachNear(float x, float y, F f) const;
+
+  // Chunks match Snake::bounds so they can be culled by their circle.
+  static const uint32_t chunk_parts = Snake::bound_chunk_parts;
+
+ private:
+  struct Entry {
+    const Snake *owner;
+    uint32_t first;
+  };
+
+  static inline int32_t sector_coord(float v) {
+    return static_cast<int32_t>(v / WorldConfig::sector_size);
+  }
+  static inline uint32_t get_sector(float x, float y);
+
+  std::vector<std::vector<Entry>> sectors;
+  // sectors holding entries of each snake, by snake id
+  std::vector<std::vector<uint32_t>> filed;
+};
+
+// Off map parts are filed under the nearest edge sector.
+inline uint32_t SegmentGrid::get_sector(float x, float y) {
+  const int32_t last = WorldConfig::sector_count_along_edge - 1;
+  int32_t sx = sector_coord(x);
+  int32_t sy = sector_coord(y);
+  sx = sx < 0 ? 0 : (sx > last ? last : sx);
+  sy = sy < 0 ? 0 : (sy > last ? last : sy);
+  return static_cast<uint32_t>(sy * WorldConfig::sector_count_along_edge + sx);
+}
+
+template <typename F>
+bool SegmentGrid::ForEachNear(float x, float y, F f) const {
+  if (sectors.empty()) {
+    return false;
+  }
+
+  return SectorSeq::ForEachIndexAround(sector_coord(x), sector_coord(y), 1, [&](size_t index) {
+    for (const Entry &e : sectors[index]) {
+      const Snake *s = e.owner;
+      const uint32_t len = static_cast<uint32_t>(s->parts.size());
+      if (e.first >= len) continue;  // tail shrank since it was filed
+
+      const uint32_t n = len - e.first < chunk_parts + 1 ? len - e.first : chunk_parts + 1;
+      const size_t b = e.first / chunk_parts;
+      if (f(Chunk{s, s->parts.x_data() + e.first, s->parts.y_data() + e.first, n,
+                  s->lsz / 2.0f, b < s->bounds.size() ? &s->bounds[b] : nullptr})) {
+        return true;
+      }
+    }
+    return false;
+  });
+}
+
+#endif  // SRC_GAME_SEGMENT_GRID_H_
@@ -0,0 +1,32 @@
+#include "game/sim_input.h"
+
+#include <fstream>
+
+bool SimInputLog::Save(const std::string &path) const {
+  std::ofstream out(path, std::ios::binary);
+  for (const SimInput &in : inputs) {
+    out.write(reinterpret_cast<const char *>(&in.frame), sizeof(in.frame));
+    out.write(reinterpret_cast<const char *>(&in.id), sizeof(in.id));
+    out.write(reinterpret_cast<const char *>(&in.type), sizeof(in.type));
+    out.write(reinterpret_cast<const char *>(&in.value), sizeof(in.value));
+  }
+  return static_cast<bool>(out);
+}
+
+bool SimInputLog::Load(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return false;
+  }
+
+  inputs.clear();
+  next = 0;
+  SimInput r;
+  while (in.read(reinterpret_cast<char *>(&r.frame), sizeof(r.frame)) &&
+         in.read(reinterpret_cast<char *>(&r.id), sizeof(r.id)) &&
+         in.read(reinterpret_cast<char *>(&r.type), sizeof(r.type)) &&
+         in.read(reinterpret_cast<char *>(&r.value), sizeof(r.value))) {
+    inputs.push_back(r);
+  }
+  return in.eof();
+}
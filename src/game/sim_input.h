@@ -0,0 +1,57 @@
+#ifndef SRC_GAME_SIM_INPUT_H_
+#define SRC_GAME_SIM_INPUT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "game/config.h"
+
+enum sim_input_t : uint8_t {
+  sim_input_steer = 0,  // value is the wanted angle
+  sim_input_boost = 1,  // value 1 starts, 0 stops
+};
+
+// A player command, applied before the frame it is stamped with.
+struct SimInput {
+  uint32_t frame;
+  snake_id_t id;
+  uint8_t type;
+  float value;
+};
+
+// Player commands of a deterministic run, in frame order. Saved runs replay
+// the exact same commands into another build or thread count.
+class SimInputLog {
+ public:
+  // frames must not decrease
+  void Add(const SimInput &in) { inputs.push_back(in); }
+  size_t size() const { return inputs.size(); }
+  void Rewind() { next = 0; }
+
+  // Binary file of raw records; false on I/O errors.
+  bool Save(const std::string &path) const;
+  bool Load(const std::string &path);
+
+  // f(const SimInput &) for the commands of `frame`, in recorded order.
+  // Frames must be visited in increasing order.
+  template <typename F>
+  void ForFrame(uint32_t frame, F f);
+
+ private:
+  std::vector<SimInput> inputs;
+  size_t next = 0;
+};
+
+template <typename F>
+void SimInputLog::ForFrame(uint32_t frame, F f) {
+  while (next < inputs.size() && inputs[next].frame < frame) {
+    next++;
+  }
+  for (; next < inputs.size() && inputs[next].frame == frame; next++) {
+    f(inputs[next]);
+  }
+}
+
+#endif  // SRC_GAME_SIM_INPUT_H_
@@ -2,31 +2,21 @@
 #include <iostream>
 #include <array>
 #include <algorithm> // For min/max
+#include <cstring>
+#include "game/danger_grid.h"
 #include "game/math.h"
 
 // ----------------------------------------------------------------------
 // MAIN TICK LOOP
 // ----------------------------------------------------------------------
 
-bool Snake::Tick(long dt, SectorSeq *ss, const WorldConfig &config) {
-  uint8_t changes = 0;
+void Snake::TickMove(long dt, const SectorSeq &ss) {
+  tick_changes = 0;
+  tick_move_ticks = 0;
+  food_candidates.clear();
 
   if (update & (change_dying | change_dead)) {
-    return false;
-  }
-
-  // --- AI LOGIC ---
-  if (bot) {
-    ai_ticks += dt;
-    if (ai_ticks > ai_step_interval) {
-      const long frames = ai_ticks / ai_step_interval;
-      const long frames_ticks = frames * ai_step_interval;
-
-      // Pass the sectors to the AI so it can see food/enemies
-      TickAI(frames, ss);
-
-      ai_ticks -= frames_ticks;
-    }
+    return;
   }
 
   // --- ROTATION LOGIC ---
@@ -50,7 +40,7 @@ bool Snake::Tick(long dt, SectorSeq *ss, const WorldConfig &config) {
 
       angle = Math::normalize_angle(angle);
 
-      changes |= change_angle;
+      tick_changes |= change_angle;
       rot_ticks -= frames_ticks;
     }
   }
@@ -58,88 +48,101 @@ bool Snake::Tick(long dt, SectorSeq *ss, const WorldConfig &config) {
   // --- MOVEMENT LOGIC ---
   mov_ticks += dt;
   const long mov_frame_interval = 1000 * WorldConfig::move_step_distance / speed;
-  if (mov_ticks >= mov_frame_interval) {
+  if (mov_ticks >= mov_frame_interval * get_move_steps(lod)) {
     const long frames = mov_ticks / mov_frame_interval;
     const long frames_ticks = frames * mov_frame_interval;
     const float move_dist = speed * frames_ticks / 1000.0f;
     const size_t len = parts.size();
 
-    // move head
-    Body &head = parts[0];
-    Body prev = head;
-    head.x += cosf(angle) * move_dist;
-    head.y += sinf(angle) * move_dist;
+    // positions before this step, the follow kernel reads them while
+    // rewriting the body in place
+    static thread_local std::vector<float> old_parts;
+    old_parts.resize(2 * len);
+    float *px = parts.x_data();
+    float *py = parts.y_data();
+    std::memcpy(old_parts.data(), px, len * sizeof(float));
+    std::memcpy(old_parts.data() + len, py, len * sizeof(float));
+    const float *ox = old_parts.data();
+    const float *oy = old_parts.data() + len;
 
-    sbb.UpdateBoxNewSectors(ss, WorldConfig::sector_size / 2, head.x, head.y,
-                            prev.x, prev.y);
-    if (!bot) {
-      vp.UpdateBoxNewSectors(ss, head.x, head.y, prev.x, prev.y);
-    }
-
-    // bound box
-    float bbx = head.x;
-    float bby = head.y;
-
-    for (size_t i = 1; i < len && i < parts_skip_count; ++i) {
-      const Body old = parts[i];
-      parts[i] = prev;
-      bbx += prev.x;
-      bby += prev.y;
-      prev = old;
+    // move head
+    px[0] += cosf(angle) * move_dist;
+    py[0] += sinf(angle) * move_dist;
+
+    // first parts take the previous position of their leader
+    const size_t skip_end = std::min<size_t>(len, parts_skip_count);
+    for (size_t i = 1; i < skip_end; ++i) {
+      px[i] = ox[i - 1];
+      py[i] = oy[i - 1];
     }
 
-    // move intermediate
-    for (size_t i = parts_skip_count, j = 0; i < len && i < parts_skip_count + parts_start_move_count; ++i) {
-      Body &pt = parts[i];
-      const Body last = parts[i - 1];
-      const Body old = pt;
-
-      pt.From(prev);
+    // move intermediate, follow coefficient ramps up to snake_tail_k
+    const size_t start_end = std::min<size_t>(len, parts_skip_count + parts_start_move_count);
+    for (size_t i = parts_skip_count, j = 0; i < start_end; ++i) {
       const float move_coeff = snake_tail_k * (++j) / parts_start_move_count;
-      pt.Offset(move_coeff * (last.x - pt.x), move_coeff * (last.y - pt.y));
-
-      bbx += pt.x;
-      bby += pt.y;
-      prev = old;
+      px[i] = ox[i - 1] + move_coeff * (px[i - 1] - ox[i - 1]);
+      py[i] = oy[i - 1] + move_coeff * (py[i - 1] - oy[i - 1]);
     }
 
     // move tail
-    for (size_t i = parts_skip_count + parts_start_move_count, j = 0; i < len; ++i) {
-      Body &pt = parts[i];
-      const Body last = parts[i - 1];
-      const Body old = pt;
-
-      pt.From(prev);
-      pt.Offset(snake_tail_k * (last.x - pt.x), snake_tail_k * (last.y - pt.y));
-
-      static const size_t tail_step =
-          static_cast<size_t>(WorldConfig::sector_size / tail_step_distance);
-      if (j + tail_step >= i) {
-        sbb.UpdateBoxNewSectors(ss, WorldConfig::sector_size / 2, pt.x, pt.y,
-                                old.x, old.y);
-        j = i;
+    BodyKernel::FollowTail(px, py, ox, oy, start_end, len, snake_tail_k);
+
+    // sector membership is updated in TickCommit, keep what it needs
+    sector_moves.clear();
+    sector_moves.push_back({px[0], py[0], ox[0], oy[0]});
+    for (size_t i = start_end; i < len; ++i) {
+      if (static_cast<int16_t>(px[i] / WorldConfig::sector_size) !=
+              static_cast<int16_t>(ox[i] / WorldConfig::sector_size) ||
+          static_cast<int16_t>(py[i] / WorldConfig::sector_size) !=
+              static_cast<int16_t>(oy[i] / WorldConfig::sector_size)) {
+        sector_moves.push_back({px[i], py[i], ox[i], oy[i]});
       }
-
-      bbx += pt.x;
-      bby += pt.y;
-      prev = old;
     }
 
-    changes |= change_pos;
+    // bound box
+    float bbx = 0.0f;
+    float bby = 0.0f;
+    BodyKernel::Sum(px, py, len, &bbx, &bby);
+
+    tick_changes |= change_pos;
+    tick_move_ticks = frames_ticks;
 
     // update bb
-    sbb.x = bbx / parts.size();
-    sbb.y = bby / parts.size();
-    vp.x = head.x;
-    vp.y = head.y;
+    sbb.x = bbx / len;
+    sbb.y = bby / len;
+    vp.x = px[0];
+    vp.y = py[0];
     UpdateBoxRadius();
+    UpdateBodyBounds();
+
+    // Check for food, eaten in TickCommit
+    FindEatenFood(ss);
+
+    mov_ticks -= frames_ticks;
+  }
+}
+
+bool Snake::TickCommit(SectorSeq *ss, const WorldConfig &config) {
+  uint8_t changes = tick_changes;
+
+  if (tick_move_ticks > 0) {
+    const long frames_ticks = tick_move_ticks;
+    const SectorMove &head = sector_moves.front();
+
+    if (!bot) {
+      vp.UpdateBoxNewSectors(ss, head.x, head.y, head.old_x, head.old_y);
+    }
+    for (const SectorMove &m : sector_moves) {
+      sbb.UpdateBoxNewSectors(ss, WorldConfig::sector_size / 2, m.x, m.y,
+                              m.old_x, m.old_y);
+    }
+
     sbb.UpdateBoxOldSectors();
     if (!bot) {
       vp.UpdateBoxOldSectors();
     }
-    
-    // Check for food
-    UpdateEatenFood(ss);
+
+    CommitEatenFood(ss);
 
     // update speed
     if (acceleration) {
@@ -167,8 +170,6 @@ bool Snake::Tick(long dt, SectorSeq *ss, const WorldConfig &config) {
       }
       changes |= change_speed;
     }
-
-    mov_ticks -= frames_ticks;
   }
 
   if (changes > 0 && changes != update) {
@@ -185,8 +186,8 @@ std::shared_ptr<Snake> Snake::get_ptr() { return shared_from_this(); }
 // AI / BOT LOGIC
 // ----------------------------------------------------------------------
 
-// 1. Find Food (Scans 5x5 sectors)
-void Snake::BotFindFood(SectorSeq *ss) {
+// 1. Find Food (Ranks 5x5 sectors by food value, then picks a pellet in the best)
+void Snake::BotFindFood(SectorSeq *ss, BotDecision *d) const {
     float hx = get_head_x();
     float hy = get_head_y();
     
@@ -194,8 +195,8 @@ void Snake::BotFindFood(SectorSeq *ss) {
     float best_y = (float)WorldConfig::game_radius;
     float max_score = -1.0f;
 
-    int16_t center_sx = static_cast<int16_t>(hx / WorldConfig::sector_size);
-    int16_t center_sy = static_cast<int16_t>(hy / WorldConfig::sector_size);
+    const int32_t center_sx = SectorSeq::get_coord(hx);
+    const int32_t center_sy = SectorSeq::get_coord(hy);
 
     // Calculate minimum turning radius based on speed
     // This prevents the "Spinning" behavior.
@@ -203,58 +204,73 @@ void Snake::BotFindFood(SectorSeq *ss) {
     float turn_radius = (speed * 0.033f) / snake_angular_speed; 
     float min_safe_dist_sq = turn_radius * turn_radius;
 
-    for (int16_t sy = center_sy - 2; sy <= center_sy + 2; ++sy) {
-        for (int16_t sx = center_sx - 2; sx <= center_sx + 2; ++sx) {
-            if (sx < 0 || sx >= WorldConfig::sector_count_along_edge ||
-                sy < 0 || sy >= WorldConfig::sector_count_along_edge) continue;
-
-            Sector *sec = ss->get_sector(sx, sy);
+    // Sector scores use the same value / distance^2 as pellets, taken from
+    // the sector center, so no pellet is read here.
+    struct SectorScore {
+        const Sector *sec;
+        float score;
+    };
+    SectorScore ranked[25];
+    size_t ranked_count = 0;
+
+    ss->ForEachSectorAround(center_sx, center_sy, 2, [&](const Sector &sec) {
+        if (sec.food_value > 0) {
+            const float dist_sq = Math::dist_sq(hx, hy, sec.box.x, sec.box.y);
+            ranked[ranked_count++] = {&sec, sec.food_value / (dist_sq + 1.0f)};
+        }
+        return false;
+    });
+
+    // Best sectors first, the next one only if all pellets of the last were
+    // skipped by the spinning check.
+    for (size_t tries = 0; tries < bot_food_sectors && ranked_count > 0 && max_score < 0.0f; tries++) {
+        SectorScore *top = std::max_element(ranked, ranked + ranked_count,
+            [](const SectorScore &a, const SectorScore &b) { return a.score < b.score; });
+        const Sector *sec = top->sec;
+        *top = ranked[--ranked_count];
+
+        for (size_t i = 0; i < sec->food.size(); i++) {
+            const Food f = sec->food[i];
+            float dist_sq = Math::dist_sq(hx, hy, f.x, f.y);
             
-            for (const Food &f : sec->food) {
-                float dist_sq = Math::dist_sq(hx, hy, f.x, f.y);
+            // ---------------------------------------------------------
+            // FIX 2: Prevent Spinning
+            // ---------------------------------------------------------
+            // If food is too close...
+            if (dist_sq < min_safe_dist_sq) {
+                // Check angle difference
+                float ang_to_food = atan2f(f.y - hy, f.x - hx);
+                float angle_diff = fabs(Math::normalize_angle(ang_to_food - angle));
                 
-                // ---------------------------------------------------------
-                // FIX 2: Prevent Spinning
-                // ---------------------------------------------------------
-                // If food is too close...
-                if (dist_sq < min_safe_dist_sq) {
-                    // Check angle difference
-                    float ang_to_food = atan2f(f.y - hy, f.x - hx);
-                    float angle_diff = fabs(Math::normalize_angle(ang_to_food - angle));
-                    
-                    // If we have to turn more than 45 degrees (PI/4) to hit something 
-                    // that is inside our turn radius, we will orbit it forever.
-                    // Ignore it so we straighten out and loop back later.
-                    if (angle_diff > (Math::f_pi / 4.0f)) {
-                        continue; 
-                    }
+                // If we have to turn more than 45 degrees (PI/4) to hit something 
+                // that is inside our turn radius, we will orbit it forever.
+                // Ignore it so we straighten out and loop back later.
+                if (angle_diff > (Math::f_pi / 4.0f)) {
+                    continue; 
                 }
-                // ---------------------------------------------------------
+            }
+            // ---------------------------------------------------------
 
-                float score = (f.size * f.size) / (dist_sq + 1.0f); // +1 to avoid div0
+            float score = Sector::get_food_value(f) / (dist_sq + 1.0f); // +1 to avoid div0
 
-                if (score > max_score) {
-                    max_score = score;
-                    best_x = f.x;
-                    best_y = f.y;
-                }
+            if (score > max_score) {
+                max_score = score;
+                best_x = f.x;
+                best_y = f.y;
             }
         }
     }
 
-    bot_target_x = best_x;
-    bot_target_y = best_y;
+    d->target_x = best_x;
+    d->target_y = best_y;
     
     // Only boost if the food is worth it AND it's reasonably far away to control the speed
-    if (fullness > 30 && max_score > 0.05f) {
-        acceleration = true;
-    } else {
-        acceleration = false;
-    }
+    d->acceleration = fullness > 30 && max_score > 0.05f;
 }
 
 // 2. Check Collision (Projects whisker)
-bool Snake::BotCheckCollision(SectorSeq *ss, float look_ahead_dist, float &out_avoid_ang) {
+bool Snake::BotCheckCollision(const DangerGrid &danger, float look_ahead_dist,
+                              float &out_avoid_ang, bool bodies) const {
     float hx = get_head_x();
     float hy = get_head_y();
     
@@ -271,73 +287,63 @@ bool Snake::BotCheckCollision(SectorSeq *ss, float look_ahead_dist, float &out_a
     }
 
     // B. Check Snake Collisions
-    int16_t sx = static_cast<int16_t>(whisker_x / WorldConfig::sector_size);
-    int16_t sy = static_cast<int16_t>(whisker_y / WorldConfig::sector_size);
-    
-    // Check 3x3 around whisker tip
-    for (int j = sy - 1; j <= sy + 1; j++) {
-        for (int i = sx - 1; i <= sx + 1; i++) {
-            if (i < 0 || i >= WorldConfig::sector_count_along_edge || 
-                j < 0 || j >= WorldConfig::sector_count_along_edge) continue;
-
-            Sector *sec = ss->get_sector(i, j);
-
-            for (const BoundBox *bb : sec->snakes) {
-                const Snake *other = bb->snake;
-                if (other == this) continue;
-
-                // Optimization: Bounding box check first
-                if (fabs(whisker_x - other->sbb.x) > other->sbb.r + 50) continue;
-                if (fabs(whisker_y - other->sbb.y) > other->sbb.r + 50) continue;
-
-                // Check Body Parts (Simplified Circle Check for speed)
-                float collision_dist_sq = (sbpr + other->sbpr + 40.0f); // Buffer 40 units
-                collision_dist_sq *= collision_dist_sq;
-
-                for (const Body &b : other->parts) {
-                    if (Math::dist_sq(whisker_x, whisker_y, b.x, b.y) < collision_dist_sq) {
-                        
-                        // Collision detected! Decide turn direction.
-                        float ang_to_obs = atan2f(b.y - hy, b.x - hx);
-                        float rel_ang = Math::normalize_angle(ang_to_obs - angle);
-
-                        // If obstacle is to our left, turn right. Else turn left.
-                        if (rel_ang > 0) {
-                            out_avoid_ang = angle - (Math::f_pi / 1.5f); 
-                        } else {
-                            out_avoid_ang = angle + (Math::f_pi / 1.5f); 
-                        }
-                        
-                        return true;
-                    }
-                }
-            }
+    if (!bodies) {
+        return false;
+    }
+
+    // Cells around the whisker tip holding another body
+    float obs_x = 0;
+    float obs_y = 0;
+    if (danger.FindDanger(whisker_x, whisker_y, id, &obs_x, &obs_y)) {
+        // Collision detected! Decide turn direction.
+        float ang_to_obs = atan2f(obs_y - hy, obs_x - hx);
+        float rel_ang = Math::normalize_angle(ang_to_obs - angle);
+
+        // If obstacle is to our left, turn right. Else turn left.
+        if (rel_ang > 0) {
+            out_avoid_ang = angle - (Math::f_pi / 1.5f); 
+        } else {
+            out_avoid_ang = angle + (Math::f_pi / 1.5f); 
         }
+        
+        return true;
     }
 
     return false;
 }
 
 // 3. AI Main Logic
-void Snake::TickAI(long frames, SectorSeq *ss) {
+Snake::BotDecision Snake::TickAI(SectorSeq *ss, const DangerGrid &danger) const {
+    BotDecision d;
+
     // 1. Find Food Target (Goal)
-    BotFindFood(ss);
+    BotFindFood(ss, &d);
 
     // 2. Default Wanted Angle: Towards Food
-    float target_ang = atan2f(bot_target_y - get_head_y(), bot_target_x - get_head_x());
+    float target_ang = atan2f(d.target_y - get_head_y(), d.target_x - get_head_x());
 
     // 3. Collision Avoidance (Override)
     // Look ahead 3x the snake width + some speed factor
     float look_ahead = (lsz * 4.0f) + (speed * 0.4f); 
     float avoid_ang = 0;
 
-    if (BotCheckCollision(ss, look_ahead, avoid_ang)) {
+    // far bots only keep away from the map edge
+    if (BotCheckCollision(danger, look_ahead, avoid_ang, lod != lod_far)) {
         target_ang = avoid_ang;
-        acceleration = false; // Stop boosting if in danger
+        d.acceleration = false; // Stop boosting if in danger
     }
 
+    d.wangle = Math::normalize_angle(target_ang);
+    return d;
+}
+
+void Snake::ApplyBotDecision(const BotDecision &d) {
+    bot_target_x = d.target_x;
+    bot_target_y = d.target_y;
+    acceleration = d.acceleration;
+
     // 4. Set Rotation
-    wangle = Math::normalize_angle(target_ang);
+    wangle = d.wangle;
     update |= change_wangle;
 }
 
@@ -345,6 +351,60 @@ void Snake::TickAI(long frames, SectorSeq *ss) {
 // STANDARD SNAKE FUNCTIONS
 // ----------------------------------------------------------------------
 
+void Snake::Reserve(size_t parts_cap, size_t food_cap, size_t box_sectors_cap,
+                    size_t view_sectors_cap) {
+  parts.reserve(parts_cap);
+  sector_moves.reserve(parts_cap);
+  food_candidates.reserve(food_cap);
+  bounds.reserve(parts_cap / bound_chunk_parts + 1);
+  eaten.reserve(food_cap);
+  spawn.reserve(food_cap);
+  sbb.sectors.reserve(box_sectors_cap);
+  vp.sectors.reserve(view_sectors_cap);
+  vp.new_sectors.reserve(view_sectors_cap);
+  vp.old_sectors.reserve(view_sectors_cap);
+}
+
+void Snake::Reset() {
+  sbb.Unregister();
+
+  // Move the storage aside, restore every field to its default and move the
+  // storage back, so recycled snakes never reallocate while growing.
+  BodySeq keep_parts(std::move(parts));
+  std::vector<BodyBound> keep_bounds(std::move(bounds));
+  std::vector<SectorMove> keep_moves(std::move(sector_moves));
+  std::vector<FoodCandidate> keep_candidates(std::move(food_candidates));
+  std::vector<FoodEatenData> keep_eaten(std::move(eaten));
+  FoodSeq keep_spawn(std::move(spawn));
+  SectorVec keep_sbb(std::move(sbb.sectors));
+  SectorVec keep_vp(std::move(vp.sectors));
+  SectorVec keep_vp_new(std::move(vp.new_sectors));
+  SectorVec keep_vp_old(std::move(vp.old_sectors));
+
+  *this = Snake();
+
+  parts = std::move(keep_parts);
+  bounds = std::move(keep_bounds);
+  sector_moves = std::move(keep_moves);
+  food_candidates = std::move(keep_candidates);
+  eaten = std::move(keep_eaten);
+  spawn = std::move(keep_spawn);
+  sbb.sectors = std::move(keep_sbb);
+  vp.sectors = std::move(keep_vp);
+  vp.new_sectors = std::move(keep_vp_new);
+  vp.old_sectors = std::move(keep_vp_old);
+
+  parts.clear();
+  bounds.clear();
+  sector_moves.clear();
+  food_candidates.clear();
+  eaten.clear();
+  spawn.clear();
+  vp.sectors.clear();
+  vp.new_sectors.clear();
+  vp.old_sectors.clear();
+}
+
 BoundBox Snake::get_new_box() const {
   return {{get_head_x(), get_head_y(), 0}, id, this, {}};
 }
@@ -375,7 +435,14 @@ void Snake::UpdateBoxRadius() {
 
   // reserve 1 step ahead of the snake radius
   sbb.r = (d + WorldConfig::move_step_distance) / 2.0f;
-  vp.r = WorldConfig::sector_diag_size * 3.0f;
+  vp.r = view_radius;
+}
+
+void Snake::UpdateBodyBounds() {
+  const size_t len = parts.size();
+  bounds.resize((len + bound_chunk_parts - 1) / bound_chunk_parts);
+  BodyKernel::ChunkBounds(parts.x_data(), parts.y_data(), len,
+                          bound_chunk_parts, bounds.data());
 }
 
 // UPDATED: AS3 Physics Constants
@@ -405,7 +472,7 @@ void Snake::UpdateSnakeConsts() {
 }
 
 void Snake::InitBoxNewSectors(SectorSeq *ss) {
-  Body &head = parts[0];
+  const Body head = parts.front();
   sbb.UpdateBoxNewSectors(ss, WorldConfig::sector_size / 2, head.x, head.y,
                           0.0f, 0.0f);
 
@@ -418,14 +485,14 @@ void Snake::InitBoxNewSectors(SectorSeq *ss) {
   // 300 / 24.0f, with radius 150
   static const size_t tail_step = static_cast<size_t>(WorldConfig::sector_size / tail_step_distance);
   for (size_t i = 3; i < len; i += tail_step) {
-    Body &pt = parts[i];
+    const Body pt = parts[i];
     sbb.UpdateBoxNewSectors(ss, WorldConfig::sector_size / 2, pt.x, pt.y, 0.0f,
                             0.0f);
   }
 }
 
 // UPDATED: 3x3 Sector Scan for Food
-void Snake::UpdateEatenFood(SectorSeq *ss) {
+void Snake::FindEatenFood(const SectorSeq &ss) {
   float head_x = get_head_x();
   float head_y = get_head_y();
 
@@ -439,35 +506,24 @@ void Snake::UpdateEatenFood(SectorSeq *ss) {
   // Calculate Eat Radius Squared (AS3: dcsc = 1600 * sc13)
   // FIX: Increased radius slightly to ensure food is consumed reliably
   float eat_dist_sq = 2000.0f * sc13;
-  float search_r = sqrtf(eat_dist_sq) + 40.0f; 
-
-  int16_t center_sx = static_cast<int16_t>(mouth_x / WorldConfig::sector_size);
-  int16_t center_sy = static_cast<int16_t>(mouth_y / WorldConfig::sector_size);
 
-  // Scan 3x3 Neighbors
-  for (int16_t sy = center_sy - 1; sy <= center_sy + 1; ++sy) {
-    for (int16_t sx = center_sx - 1; sx <= center_sx + 1; ++sx) {
-        
-        if (sx < 0 || sx >= WorldConfig::sector_count_along_edge ||
-            sy < 0 || sy >= WorldConfig::sector_count_along_edge) continue;
+  ss.ForEachFoodInRadius(mouth_x, mouth_y, sqrtf(eat_dist_sq), [&](size_t index, const Food &f) {
+    food_candidates.push_back({index, f});
+    return false;
+  });
+}
 
-        Sector *sec = ss->get_sector(sx, sy);
-        
-        auto it = sec->food.begin();
-        while (it != sec->food.end()) {
-            // Fast Bounding Box Check
-            if (fabs(it->x - mouth_x) < search_r && fabs(it->y - mouth_y) < search_r) {
-                // Exact Distance Check
-                if (Math::dist_sq(it->x, it->y, mouth_x, mouth_y) < eat_dist_sq) {
-                    on_food_eaten(*it);
-                    it = sec->food.erase(it);
-                    continue; 
-                }
-            }
-            ++it;
-        }
+// Snakes earlier in the commit order may have eaten a candidate already.
+void Snake::CommitEatenFood(SectorSeq *ss) {
+  for (const FoodCandidate &c : food_candidates) {
+    Sector &sec = (*ss)[c.sector];
+    const size_t i = sec.food.Find(c.food);
+    if (i != sec.food.size()) {
+      on_food_eaten(c.food);
+      sec.Remove(i);
     }
   }
+  food_candidates.clear();
 }
 
 // Legacy Intersect (Required by World::CheckSnakeBounds logic for optimization)
@@ -501,7 +557,7 @@ void Snake::DecreaseSnake(uint16_t volume, uint8_t drop_size) {
     const uint16_t reduce = static_cast<uint16_t>(1 + volume / 100);
     for (uint16_t i = 0; i < reduce; i++) {
       if (parts.size() > 3) {
-        const Body &last = parts.back();
+        const Body last = parts.back();
         SpawnFood({static_cast<uint16_t>(last.x),
                    static_cast<uint16_t>(last.y),
                    drop_size,
@@ -534,7 +590,7 @@ void Snake::SpawnFood(Food f) {
   }
 }
 
-void Snake::on_dead_food_spawn(SectorSeq *ss, std::function<float()> next_randomf) {
+void Snake::on_dead_food_spawn(SectorSeq *ss, Random *rng) {
   auto end = parts.end();
   const float r = get_snake_body_part_radius();
   const uint16_t r2 = static_cast<uint16_t>(r * 3);
@@ -553,9 +609,9 @@ void Snake::on_dead_food_spawn(SectorSeq *ss, std::function<float()> next_random
         sy < WorldConfig::sector_count_along_edge) {
       
       for (size_t j = 0; j < count; j++) {
-        Food f = {static_cast<uint16_t>(i->x + r - next_randomf() * r2),
-                  static_cast<uint16_t>(i->y + r - next_randomf() * r2),
-                  food_size, static_cast<uint8_t>(29 * next_randomf())};
+        Food f = {static_cast<uint16_t>(i->x + r - rng->Nextf() * r2),
+                  static_cast<uint16_t>(i->y + r - rng->Nextf() * r2),
+                  food_size, static_cast<uint8_t>(29 * rng->Nextf())};
 
         // Double check food bounds
         if (f.x < WorldConfig::game_radius * 2 && f.y < WorldConfig::game_radius * 2) {
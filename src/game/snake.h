@@ -13,9 +13,10 @@ RELATIVE PATH: game/snake.h
 #include <string>
 #include <vector>
 #include <unordered_map>
-#include <functional> 
 
+#include "game/body.h"
 #include "game/config.h"
+#include "game/random.h"
 #include "game/sector.h"
 
 struct FoodEatenData {
@@ -37,17 +38,15 @@ enum snake_changes_t : uint8_t {
   change_dead = 1 << 6
 };
 
-struct Body {
-  float x; float y;
-  inline void From(const Body &p) { x = p.x; y = p.y; }
-  inline void Offset(float dx, float dy) { x += dx; y += dy; }
-  inline float DistanceSquared(float dx, float dy) const {
-    const float a = x - dx; const float b = y - dy; return a * a + b * b;
-  }
+// Simulation detail of a bot, by distance to the nearest human, see BotLod.
+enum bot_lod_t : uint8_t {
+  lod_full = 0,  // may be seen by a player
+  lod_near = 1,  // thinks half as often
+  lod_far = 2,   // thinks a quarter as often, moves in double steps, avoids only the edge
+  lod_count = 3
 };
 
-typedef std::vector<Body> BodySeq;
-typedef std::vector<Body>::const_iterator BodySeqCIter;
+class DangerGrid;
 
 class Snake : public std::enable_shared_from_this<Snake> {
  public:
@@ -62,6 +61,7 @@ class Snake : public std::enable_shared_from_this<Snake> {
   // --- NEW FLAG ---
   bool newly_spawned = true; 
   // ----------------
+  uint8_t lod = lod_full;
 
   std::string name;
   std::string custom_skin_data;
@@ -74,6 +74,9 @@ class Snake : public std::enable_shared_from_this<Snake> {
   SnakeBoundBox sbb;
   ViewPort vp;
   BodySeq parts;
+  // Bounding circle per bound_chunk_parts parts, refreshed when the snake
+  // moves. May lag behind parts that grew since, those are not covered.
+  std::vector<BodyBound> bounds;
   std::vector<FoodEatenData> eaten;
   FoodSeq spawn;
   size_t clientPartsIndex;
@@ -86,13 +89,38 @@ class Snake : public std::enable_shared_from_this<Snake> {
   float bot_target_x = 0;
   float bot_target_y = 0;
 
-  bool Tick(long dt, SectorSeq *ss, const WorldConfig &config);
-  void TickAI(long frames, SectorSeq *ss);
+  // Pooling support, see SnakePool. Reset() unregisters the snake from its
+  // sectors and restores defaults while keeping the capacity of all vectors.
+  void Reserve(size_t parts_cap, size_t food_cap, size_t box_sectors_cap,
+               size_t view_sectors_cap);
+  void Reset();
+
+  // What a bot wants to do, decided by TickAI and applied later.
+  struct BotDecision {
+    float target_x = 0;
+    float target_y = 0;
+    float wangle = 0;
+    bool acceleration = false;
+  };
+
+  // A frame runs in three phases over all snakes, see World::TickSnakes.
+  // Bot AI (scheduled by BotScheduler) and TickMove (rotation, movement,
+  // food lookup) write only this snake and read the others and the sectors,
+  // so each phase may run for many snakes in parallel. TickCommit applies
+  // what touches shared state (sector membership, eaten and dropped food)
+  // and must run serially.
+  void TickMove(long dt, const SectorSeq &ss);
+  bool TickCommit(SectorSeq *ss, const WorldConfig &config);
+  // Read only, so decisions of many bots can be made against the same frame.
+  BotDecision TickAI(SectorSeq *ss, const DangerGrid &danger) const;
+  void ApplyBotDecision(const BotDecision &d);
   void UpdateBoxCenter();
   void UpdateBoxRadius();
+  void UpdateBodyBounds();
   void UpdateSnakeConsts();
   void InitBoxNewSectors(SectorSeq *ss);
-  void UpdateEatenFood(SectorSeq *ss);
+  void FindEatenFood(const SectorSeq &ss);
+  void CommitEatenFood(SectorSeq *ss);
 
   bool Intersect(BoundBoxPos foe) const;
 
@@ -100,18 +128,18 @@ class Snake : public std::enable_shared_from_this<Snake> {
   void DecreaseSnake(uint16_t volume, uint8_t drop_size);
   void SpawnFood(Food f);
 
-  void on_dead_food_spawn(SectorSeq *ss, std::function<float()> next_randomf);
+  void on_dead_food_spawn(SectorSeq *ss, Random *rng);
   void on_food_eaten(Food f);
 
   float get_snake_scale() const;
   float get_snake_body_part_radius() const;
   uint16_t get_snake_score() const;
 
-  inline const Body &get_head() const { return parts[0]; }
-  inline float get_head_x() const { return parts[0].x; }
-  inline float get_head_y() const { return parts[0].y; }
-  inline float get_head_dx() const { return parts[0].x - parts[1].x; }
-  inline float get_head_dy() const { return parts[0].y - parts[1].y; }
+  inline Body get_head() const { return parts.front(); }
+  inline float get_head_x() const { return parts.x_data()[0]; }
+  inline float get_head_y() const { return parts.y_data()[0]; }
+  inline float get_head_dx() const { return parts.x_data()[0] - parts.x_data()[1]; }
+  inline float get_head_dy() const { return parts.y_data()[0] - parts.y_data()[1]; }
 
   std::shared_ptr<Snake> get_ptr();
   BoundBox get_new_box() const;
@@ -131,17 +159,52 @@ class Snake : public std::enable_shared_from_this<Snake> {
   static const int parts_skip_count = 3;
   static const int parts_start_move_count = 4;
   static constexpr float tail_step_distance = 24.0f;
+  static const uint32_t bound_chunk_parts = 8;
   static constexpr float rot_step_angle = 1.0f * WorldConfig::move_step_distance / boost_speed * snake_angular_speed; 
   static const long rot_step_interval = static_cast<long>(1000.0f * rot_step_angle / snake_angular_speed);
   static const long ai_step_interval = 250; 
+  // sectors a bot looks into for a pellet, best ranked first
+  static const size_t bot_food_sectors = 3;
+  static constexpr float view_radius = WorldConfig::sector_diag_size * 3.0f;
+
+  // AI interval and movement step multipliers per bot_lod_t
+  static inline long get_ai_interval(uint8_t lod) { return ai_step_interval << lod; }
+  static inline long get_move_steps(uint8_t lod) { return lod == lod_far ? 2 : 1; }
+  // time since the last AI decision, in ms
+  long get_ai_ticks() const { return ai_ticks; }
 
  private:
+  // a part that moved to another sector, the head is always recorded first
+  struct SectorMove {
+    float x;
+    float y;
+    float old_x;
+    float old_y;
+  };
+
+  struct FoodCandidate {
+    size_t sector;  // index in SectorSeq
+    Food food;
+  };
+
   long mov_ticks = 0;
   long rot_ticks = 0;
+  // AI clock and queue state, owned by BotScheduler
   long ai_ticks = 0;
+  long ai_phase = 0;
+  bool ai_queued = false;
+
+  // carried from TickMove to TickCommit
+  uint8_t tick_changes = 0;
+  long tick_move_ticks = 0;        // 0 if the snake did not move
+  std::vector<SectorMove> sector_moves;
+  std::vector<FoodCandidate> food_candidates;
+
+  void BotFindFood(SectorSeq *ss, BotDecision *d) const;
+  bool BotCheckCollision(const DangerGrid &danger, float look_ahead_dist,
+                         float &out_avoid_ang, bool bodies) const;
 
-  void BotFindFood(SectorSeq *ss);
-  bool BotCheckCollision(SectorSeq *ss, float look_ahead_dist, float &out_avoid_ang);
+  friend class BotScheduler;
 
  private:
   float gsc = 0.0f;
@@ -0,0 +1,69 @@
+#include "game/snake_pool.h"
+
+SnakePool::~SnakePool() {
+  for (Snake *s : free_list) {
+    delete s;
+  }
+  for (Snake *s : reserved) {
+    delete s;
+  }
+}
+
+void SnakePool::Reserve(size_t count) {
+  reserved.reserve(count);
+  while (get_free() < count) {
+    reserved.push_back(Allocate());
+  }
+}
+
+Snake::Ptr SnakePool::Acquire() {
+  Snake *s = nullptr;
+  if (!free_list.empty()) {
+    s = free_list.back();
+    free_list.pop_back();
+    stats.reused++;
+  } else if (!reserved.empty()) {
+    s = reserved.back();
+    reserved.pop_back();
+    stats.reserved++;
+  } else {
+    s = Allocate();
+  }
+
+  stats.acquired++;
+  in_use++;
+  return Snake::Ptr(s, [this](Snake *ptr) { Release(ptr); });
+}
+
+Snake *SnakePool::Allocate() {
+  Snake *s = new Snake();
+  s->Reserve(reserve_parts, reserve_food, reserve_box_sectors,
+             reserve_view_sectors);
+  stats.created++;
+  return s;
+}
+
+void SnakePool::Release(Snake *s) {
+  s->Reset();
+  free_list.push_back(s);
+  stats.released++;
+  in_use--;
+}
+
+size_t SnakePool::get_in_use() const { return in_use; }
+
+size_t SnakePool::get_free() const { return free_list.size() + reserved.size(); }
+
+const SnakePool::Stats &SnakePool::get_stats() const { return stats; }
+
+std::ostream &operator<<(std::ostream &out, const SnakePool &p) {
+  const SnakePool::Stats &st = p.get_stats();
+  const uint64_t reuse_pct = st.acquired > 0 ? 100 * st.reused / st.acquired : 0;
+  return out << "snake pool: in_use = " << p.get_in_use()
+             << ", free = " << p.get_free()
+             << ", acquired = " << st.acquired
+             << ", created = " << st.created
+             << ", reused = " << st.reused << " (" << reuse_pct << "%)"
+             << ", reserved = " << st.reserved
+             << ", released = " << st.released;
+}
@@ -0,0 +1,58 @@
+#ifndef SRC_GAME_SNAKE_POOL_H_
+#define SRC_GAME_SNAKE_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "game/snake.h"
+
+// Recycles Snake objects between spawns. Released snakes keep the capacity of
+// their body, food and sector vectors, so respawning bots and growing snakes
+// do not go back to the allocator.
+//
+// Snakes handed out by Acquire() return to the pool when their last
+// shared_ptr goes away, so the pool must outlive every snake it produced.
+class SnakePool {
+ public:
+  struct Stats {
+    uint64_t acquired = 0;  // total Acquire() calls
+    uint64_t created = 0;   // snakes allocated because the free list was empty
+    uint64_t reused = 0;    // released snakes taken from the free list
+    uint64_t reserved = 0;  // snakes from Reserve() handed out the first time
+    uint64_t released = 0;  // snakes returned to the pool
+  };
+
+  SnakePool() = default;
+  SnakePool(const SnakePool &) = delete;
+  SnakePool &operator=(const SnakePool &) = delete;
+  ~SnakePool();
+
+  // Preallocates snakes until at least `count` are sitting in the free list.
+  void Reserve(size_t count);
+  Snake::Ptr Acquire();
+
+  size_t get_in_use() const;
+  size_t get_free() const;
+  const Stats &get_stats() const;
+
+  // Initial capacities of a pooled snake.
+  static const size_t reserve_parts = WorldConfig::max_snake_parts + 1;
+  static const size_t reserve_food = 64;
+  static const size_t reserve_box_sectors = 32;
+  static const size_t reserve_view_sectors = 49;  // 7x7 viewport scan
+
+ private:
+  Snake *Allocate();
+  void Release(Snake *s);
+
+  std::vector<Snake *> free_list;  // released snakes, handed out first
+  std::vector<Snake *> reserved;   // from Reserve(), never handed out
+  size_t in_use = 0;
+  Stats stats;
+};
+
+std::ostream &operator<<(std::ostream &out, const SnakePool &p);
+
+#endif  // SRC_GAME_SNAKE_POOL_H_
@@ -0,0 +1,195 @@
+#include "game/trace.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Spans of one thread. The thread appends, the flusher consumes, so the
+// two indices are the only shared state.
+struct TraceBuffer {
+  struct Span {
+    const char *name;
+    int64_t begin;
+    int64_t end;
+  };
+
+  static const size_t capacity = 1 << 14;
+
+  Span spans[capacity];
+  std::atomic<size_t> written{0};
+  std::atomic<size_t> read{0};
+  std::atomic<uint64_t> dropped{0};
+  uint32_t tid = 0;
+  std::string thread_name;  // under registry_mutex
+};
+
+std::atomic<bool> Tracer::enabled{false};
+thread_local const char *TraceScope::current = nullptr;
+
+static thread_local TraceBuffer *thread_buffer = nullptr;
+static thread_local std::string thread_name;
+
+// Buffers live until exit, threads may still write after a capture.
+static std::mutex registry_mutex;
+static std::vector<std::unique_ptr<TraceBuffer>> registry;
+
+// The capture, changed by Start and Stop under control_mutex.
+static std::mutex control_mutex;
+static std::condition_variable stop_changed;
+static bool stop_requested = false;
+static std::thread flusher;
+static FILE *out = nullptr;
+static int64_t capture_start = 0;
+
+int64_t Tracer::NowNs() {
+  using std::chrono::duration_cast;
+  using std::chrono::nanoseconds;
+  using std::chrono::steady_clock;
+  return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static TraceBuffer *RegisterThread() {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  registry.emplace_back(new TraceBuffer());
+  TraceBuffer *b = registry.back().get();
+  b->tid = static_cast<uint32_t>(registry.size());
+  b->thread_name = thread_name.empty() ? "thread " + std::to_string(b->tid) : thread_name;
+  return b;
+}
+
+void Tracer::SetThreadName(const std::string &name) {
+  thread_name = name;
+  if (thread_buffer != nullptr) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    thread_buffer->thread_name = name;
+  }
+}
+
+void Tracer::Record(const char *name, int64_t begin_ns, int64_t end_ns) {
+  if (thread_buffer == nullptr) {
+    thread_buffer = RegisterThread();
+  }
+  TraceBuffer *b = thread_buffer;
+  const size_t w = b->written.load(std::memory_order_relaxed);
+  if (w - b->read.load(std::memory_order_acquire) >= TraceBuffer::capacity) {
+    b->dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  b->spans[w % TraceBuffer::capacity] = TraceBuffer::Span{name, begin_ns, end_ns};
+  b->written.store(w + 1, std::memory_order_release);
+}
+
+// Writes the new spans of every buffer, skipping the ones that began before
+// the capture. Returns the spans dropped so far.
+static uint64_t Drain(bool *first) {
+  std::vector<TraceBuffer *> buffers;
+  {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (auto &b : registry) {
+      buffers.push_back(b.get());
+    }
+  }
+
+  uint64_t dropped = 0;
+  for (TraceBuffer *b : buffers) {
+    const size_t r = b->read.load(std::memory_order_relaxed);
+    const size_t w = b->written.load(std::memory_order_acquire);
+    for (size_t i = r; i < w; i++) {
+      const TraceBuffer::Span &s = b->spans[i % TraceBuffer::capacity];
+      if (s.begin < capture_start) {
+        continue;
+      }
+      fprintf(out, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+              *first ? "" : ",", s.name, b->tid, (s.begin - capture_start) / 1e3,
+              (s.end - s.begin) / 1e3);
+      *first = false;
+    }
+    b->read.store(w, std::memory_order_release);
+    dropped += b->dropped.load(std::memory_order_relaxed);
+  }
+  return dropped;
+}
+
+bool Tracer::Start(const std::string &path, long ms) {
+  std::lock_guard<std::mutex> lock(control_mutex);
+  if (is_enabled()) {
+    return false;
+  }
+  if (flusher.joinable()) {
+    flusher.join();
+  }
+
+  out = fopen(path.c_str(), "w");
+  if (out == nullptr) {
+    return false;
+  }
+  fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+  {
+    std::lock_guard<std::mutex> registry_lock(registry_mutex);
+    for (auto &b : registry) {
+      b->dropped.store(0, std::memory_order_relaxed);
+    }
+  }
+  stop_requested = false;
+  capture_start = NowNs();
+  enabled.store(true);
+  flusher = std::thread(&Tracer::FlushLoop, ms);
+  return true;
+}
+
+void Tracer::Stop() {
+  std::thread running;
+  {
+    std::lock_guard<std::mutex> lock(control_mutex);
+    stop_requested = true;
+    running = std::move(flusher);
+  }
+  stop_changed.notify_all();
+
+  if (running.joinable()) {
+    running.join();
+  }
+}
+
+void Tracer::FlushLoop(long ms) {
+  static const std::chrono::milliseconds flush_interval(50);
+  const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+  bool first = true;
+
+  std::unique_lock<std::mutex> lock(control_mutex, std::defer_lock);
+  for (;;) {
+    lock.lock();
+    const bool stop = stop_changed.wait_until(
+        lock, std::min(end, std::chrono::steady_clock::now() + flush_interval),
+        [] { return stop_requested; });
+    lock.unlock();
+    if (stop || std::chrono::steady_clock::now() >= end) {
+      break;
+    }
+    Drain(&first);
+  }
+
+  // Spans still open at the end are lost, the ones closed by now are not.
+  enabled.store(false);
+  const uint64_t dropped = Drain(&first);
+
+  {
+    std::lock_guard<std::mutex> registry_lock(registry_mutex);
+    for (auto &b : registry) {
+      fprintf(out,
+              "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+              "\"args\":{\"name\":\"%s\"}}",
+              first ? "" : ",", b->tid, b->thread_name.c_str());
+      first = false;
+    }
+  }
+  fprintf(out, "\n],\"otherData\":{\"dropped_spans\":\"%llu\"}}\n",
+          static_cast<unsigned long long>(dropped));
+  fclose(out);
+  out = nullptr;
+}
@@ -0,0 +1,81 @@
+#ifndef SRC_GAME_TRACE_H_
+#define SRC_GAME_TRACE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Captures spans in the Chrome trace event format, for chrome://tracing or
+// ui.perfetto.dev. Off unless a capture runs, then each thread appends its
+// spans to its own buffer without locks and a background thread drains the
+// buffers to the file until the capture window ends. Spans that do not fit
+// a full buffer are dropped and counted in the file.
+class Tracer {
+ public:
+  // Starts capturing for `ms` milliseconds into the JSON file at path.
+  // False if a capture is running or the file cannot be opened.
+  static bool Start(const std::string &path, long ms);
+  // Ends the capture early and waits until the file is written.
+  static void Stop();
+
+  static bool is_enabled() { return enabled.load(std::memory_order_relaxed); }
+  // Name of the calling thread in the trace.
+  static void SetThreadName(const std::string &name);
+
+  static int64_t NowNs();
+  // name must outlive the capture, spans are named by string literals.
+  static void Record(const char *name, int64_t begin_ns, int64_t end_ns);
+
+ private:
+  static void FlushLoop(long ms);
+
+  static std::atomic<bool> enabled;
+};
+
+// Records the time until destruction as a span, if a capture is running.
+// Next ends the span and starts the following one, for consecutive phases.
+class TraceScope {
+ public:
+  explicit TraceScope(const char *in_name) : parent(current) {
+    if (in_name != nullptr && Tracer::is_enabled()) {
+      Begin(in_name);
+    }
+  }
+  ~TraceScope() { End(); }
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+
+  void Next(const char *in_name) {
+    End();
+    if (Tracer::is_enabled()) {
+      Begin(in_name);
+    }
+  }
+
+  // The innermost span of the calling thread, names the jobs it spawns.
+  static const char *get_current() { return current; }
+
+ private:
+  void Begin(const char *in_name) {
+    name = in_name;
+    begin = Tracer::NowNs();
+    current = name;
+  }
+
+  void End() {
+    if (name != nullptr) {
+      Tracer::Record(name, begin, Tracer::NowNs());
+      current = parent;
+      name = nullptr;
+    }
+  }
+
+  const char *name = nullptr;
+  const char *parent;
+  int64_t begin = 0;
+
+  static thread_local const char *current;
+};
+
+#endif  // SRC_GAME_TRACE_H_
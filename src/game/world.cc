@@ -7,50 +7,21 @@ RELATIVE PATH: game/world.cc
 #include "game/world.h"
 
 #include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <ctime>
 #include <iostream>
 #include <vector>
 
+#include "game/collision.h"
 #include "game/math.h"
+#include "game/trace.h"
 #include "game/bot_names.h" 
 
-// --- NEW: Safety Check Implementation ---
-bool World::IsLocationSafe(float x, float y, float safety_radius) {
-    int16_t sx = static_cast<int16_t>(x / WorldConfig::sector_size);
-    int16_t sy = static_cast<int16_t>(y / WorldConfig::sector_size);
-    
-    float safe_sq = safety_radius * safety_radius;
-
-    // Check 3x3 sectors around the spawn point
-    for (int j = sy - 1; j <= sy + 1; j++) {
-        for (int i = sx - 1; i <= sx + 1; i++) {
-            // Boundary checks for sectors
-            if (i < 0 || i >= WorldConfig::sector_count_along_edge || 
-                j < 0 || j >= WorldConfig::sector_count_along_edge) continue;
-
-            Sector *sec = sectors.get_sector(i, j);
-
-            // Iterate over all snakes currently in this sector
-            for (const BoundBox *bb : sec->snakes) {
-                const Snake *other = bb->snake;
-                
-                // Check distance to the other snake's head
-                if (Math::dist_sq(x, y, other->get_head_x(), other->get_head_y()) < safe_sq) {
-                    return false; // Too close!
-                }
-
-                // Optional: Check distance to *any* body part if you want to be super safe
-                // but checking the head is usually sufficient for spawning.
-            }
-        }
-    }
-    return true;
-}
-
 Snake::Ptr World::CreateSnake(int start_len) {
   lastSnakeId++;
 
-  auto s = std::make_shared<Snake>();
+  auto s = snake_pool.Acquire();
   s->id = lastSnakeId;
   s->name = "";
   s->skin = static_cast<uint8_t>(9 + NextRandom(21 - 9 + 1));
@@ -58,42 +29,24 @@ Snake::Ptr World::CreateSnake(int start_len) {
   s->fullness = 0;
 
   // --- IMPROVED SPAWN LOGIC ---
-  float angle;
-  float dist;
+  // Spawn in a random sector of the ring that holds no body part, around
+  // its center so neighbouring bodies stay a quarter sector away. If the
+  // ring is full, spawn anywhere in it.
   uint16_t x, y;
-  
-  // Try up to 20 times to find a safe spot
-  // If the server is super crowded, we give up and spawn at the last generated point
-  int attempts = 0;
-  bool safe = false;
-  
-  // Buffer from the absolute edge to prevent instant death (1500 units)
-  const float max_spawn_radius = WorldConfig::game_radius - 1500.0f;
-  // Distance to keep away from other snake heads (500 units)
-  const float safety_buffer = 500.0f;
-
-  while (attempts < 20) {
-      angle = Math::f_2pi * NextRandomf();
+  if (danger.get_free_count() > 0) {
+      const uint32_t sector = danger.get_free_sector(NextRandom(danger.get_free_count()));
+      danger.Reserve(sector);
+
+      const Sector &sec = sectors[sector];
+      const float spread = WorldConfig::sector_size / 2.0f;
+      x = static_cast<uint16_t>(sec.box.x + (NextRandomf() - 0.5f) * spread);
+      y = static_cast<uint16_t>(sec.box.y + (NextRandomf() - 0.5f) * spread);
+  } else {
+      const float angle = Math::f_2pi * NextRandomf();
       
-      // Random distance from 1000 (avoid dead center) to Max Safe Radius
       // Using sqrt for uniform area distribution (so we don't clump in the middle)
-      float random_factor = sqrt(NextRandomf()); 
-      dist = 1000.0f + random_factor * (max_spawn_radius - 1000.0f);
-      
-      float fx = WorldConfig::game_radius + dist * cosf(angle);
-      float fy = WorldConfig::game_radius + dist * sinf(angle);
-      
-      if (IsLocationSafe(fx, fy, safety_buffer)) {
-          x = static_cast<uint16_t>(fx);
-          y = static_cast<uint16_t>(fy);
-          safe = true;
-          break;
-      }
-      attempts++;
-  }
-
-  // Fallback: If map is full, just calculate based on last attempt
-  if (!safe) {
+      const float random_factor = sqrt(NextRandomf()); 
+      const float dist = spawn_min_radius + random_factor * (spawn_max_radius - spawn_min_radius);
       x = static_cast<uint16_t>(WorldConfig::game_radius + dist * cosf(angle));
       y = static_cast<uint16_t>(WorldConfig::game_radius + dist * sinf(angle));
   }
@@ -102,7 +55,7 @@ Snake::Ptr World::CreateSnake(int start_len) {
   // so they don't immediately drive into the wall
   float angle_to_center = atan2f(WorldConfig::game_radius - y, WorldConfig::game_radius - x);
   // Add a little randomness to the angle (-45 to +45 degrees)
-  angle = angle_to_center + (NextRandomf() * 1.5f - 0.75f);
+  float angle = angle_to_center + (NextRandomf() * 1.5f - 0.75f);
   
   // Normalize
   angle = Math::normalize_angle(angle);
@@ -133,10 +86,12 @@ Snake::Ptr World::CreateSnake(int start_len) {
   s->angle = Math::normalize_angle(angle);
   s->wangle = Math::normalize_angle(angle);
 
-  s->sbb = SnakeBoundBox(s->get_new_box());
-  s->vp = ViewPort(s->get_new_box());
+  const BoundBox box = s->get_new_box();
+  s->sbb.Reset(box, box.id, box.snake);
+  s->vp.Reset(box, box.id, box.snake);
   s->UpdateBoxCenter();
   s->UpdateBoxRadius();
+  s->UpdateBodyBounds();
   s->UpdateSnakeConsts();
   s->InitBoxNewSectors(&sectors);
 
@@ -161,46 +116,177 @@ Snake::Ptr World::CreateSnakeBot() {
   return ptr;
 }
 
-void World::InitRandom() { std::srand(std::time(nullptr)); }
+void World::InitRandom() {
+  seed = config.random_seed;
+  if (seed == 0 && config.deterministic) {
+    seed = deterministic_seed;
+  } else if (seed == 0) {
+    seed = static_cast<uint64_t>(std::time(nullptr)) ^
+           static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+  }
+
+  rng.Seed(seed, 0);
+}
 
-int World::NextRandom() { return std::rand(); }
+int World::NextRandom() { return static_cast<int>(rng.Next() >> 1); }
 
-float World::NextRandomf() { return 1.0f * std::rand() / RAND_MAX; }
+float World::NextRandomf() { return rng.Nextf(); }
 
 template <typename T>
 T World::NextRandom(T base) {
-  return static_cast<T>(NextRandom() % base);
+  return static_cast<T>(rng.Next(static_cast<uint32_t>(base)));
+}
+
+static inline int64_t ElapsedNs(std::chrono::steady_clock::time_point *since) {
+  const auto now = std::chrono::steady_clock::now();
+  const int64_t ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now - *since).count();
+  *since = now;
+  return ns;
 }
 
+uint64_t World::GetSeed() const { return seed; }
+
+Random &World::GetRandom() { return rng; }
+
 void World::Tick(long dt) {
+  TraceScope trace("World::Tick");
+  if (config.deterministic) {
+    dt = WorldConfig::frame_time_ms;
+  }
+
   ticks += dt;
   const long vfr = ticks / WorldConfig::frame_time_ms;
   if (vfr > 0) {
     const long vfr_time = vfr * WorldConfig::frame_time_ms;
     TickSnakes(vfr_time);
+    auto t = std::chrono::steady_clock::now();
     RegenerateFood();
+    phases.food = ElapsedNs(&t);
     ticks -= vfr_time;
     frames += vfr;
+    if (config.deterministic) {
+      HashFrame();
+    }
+  }
+}
+
+// FNV-1a over 32 bit words, floats by their bits.
+static inline void HashWord(uint64_t *h, uint32_t v) {
+  *h = (*h ^ v) * 1099511628211ull;
+}
+
+static inline void HashFloat(uint64_t *h, float v) {
+  uint32_t bits;
+  std::memcpy(&bits, &v, sizeof(bits));
+  HashWord(h, bits);
+}
+
+void World::HashFrame() {
+  uint64_t h = frame_hash ^ 14695981039346656037ull;
+  HashWord(&h, frames);
+  for (const Snake *s : tick_order) {
+    HashWord(&h, s->id);
+    HashWord(&h, static_cast<uint32_t>(s->parts.size()));
+    const float *px = s->parts.x_data();
+    const float *py = s->parts.y_data();
+    for (size_t i = 0; i < s->parts.size(); i++) {
+      HashFloat(&h, px[i]);
+      HashFloat(&h, py[i]);
+    }
+    HashFloat(&h, s->angle);
+    HashFloat(&h, s->wangle);
+    HashWord(&h, s->fullness);
+  }
+  for (const Sector &sec : sectors) {
+    HashWord(&h, static_cast<uint32_t>(sec.food.size()));
+    HashWord(&h, sec.food_value);
+  }
+  frame_hash = h;
+}
+
+void World::ApplyInput(const SimInput &in) {
+  auto sn_i = snakes.find(in.id);
+  if (sn_i == snakes.end()) {
+    return;
+  }
+
+  Snake *s = sn_i->second.get();
+  switch (in.type) {
+    case sim_input_steer:
+      s->wangle = in.value;
+      s->update |= change_wangle;
+      break;
+    case sim_input_boost:
+      s->acceleration = in.value != 0.0f;
+      break;
+    default:
+      break;
   }
 }
 
+uint32_t World::GetFrame() const { return frames; }
+
+uint64_t World::GetFrameHash() const { return frame_hash; }
+
+const TickPhases &World::GetTickPhases() const { return phases; }
+
 void World::TickSnakes(long dt) {
-  for (auto pair : snakes) {
-    Snake *const s = pair.second.get();
+  // Bot AI and move only write to their own snake, so they run in parallel.
+  // Everything shared (sectors, food, the segment index) is touched in the
+  // commit loop, in tick_order, so results do not depend on the thread count.
+  TraceScope trace("World::TickSnakes");
+  TraceScope phase("BotAi::Tick");
+  auto t = std::chrono::steady_clock::now();
+  if (config.bot_lod) {
+    bot_lod.Update(tick_order, dt);
+  }
+  bot_ai.Tick(dt, &sectors, danger, &jobs);
+  phases.bot_ai = ElapsedNs(&t);
+
+  phase.Next("Snake::TickMove");
+  jobs.ParallelFor(tick_order.size(), sim_grain, [this, dt](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      tick_order[i]->TickMove(dt, sectors);
+    }
+  });
+  phases.move = ElapsedNs(&t);
 
-    if (s->Tick(dt, &sectors, config)) {
+  phase.Next("Snake::TickCommit");
+  for (Snake *s : tick_order) {
+    if (s->TickCommit(&sectors, config)) {
       changes.push_back(s);
+      if (s->update & change_pos) {
+        segments.Update(s);
+        danger.Update(s);
+      }
     }
   }
+  phases.commit = ElapsedNs(&t);
 
-  for (auto s : changes) {
-    if (s->update & change_pos) {
-      CheckSnakeBounds(s);
-    }
+  // Collision only reads the snakes, deaths are applied after it.
+  phase.Next("CheckSnakeBounds");
+  for (std::vector<SnakeHit> &hits : hit_scratch) {
+    hits.clear();
   }
+  jobs.ParallelFor(changes.size(), sim_grain, [this](size_t begin, size_t end) {
+    std::vector<SnakeHit> *hits = &hit_scratch[JobSystem::get_thread_index()];
+    for (size_t i = begin; i < end; i++) {
+      if (changes[i]->update & change_pos) {
+        CheckSnakeBounds(static_cast<uint32_t>(i), changes[i], hits);
+      }
+    }
+  });
+  phase.Next("ApplySnakeHits");
+  ApplySnakeHits();
+  phases.collision = ElapsedNs(&t);
 }
 
 void World::RegenerateFood() {
+    TraceScope trace("World::RegenerateFood");
+    // Eaten and dropped food of this frame
+    food_regen.Sync(&sectors);
+
     // 1. Calculate Total Probability Weight
     uint32_t w_near = config.spawn_prob_near_snake;
     uint32_t w_on   = config.spawn_prob_on_snake;
@@ -210,77 +296,82 @@ void World::RegenerateFood() {
     // Safety check to prevent divide by zero
     if (total_weight == 0) total_weight = 1;
 
-    for (int i = 0; i < config.food_spawn_rate; i++) {
-        Sector* target_sector = nullptr;
-        
+    // Every pellet lands in a sector below capacity, so the map refills at
+    // food_spawn_rate per frame until no sector lacks food.
+    for (int i = 0; i < config.food_spawn_rate && food_regen.get_total() > 0; i++) {
+        int32_t target = -1;
+
         // Roll the dice (0 to total_weight - 1)
         uint32_t roll = NextRandom(total_weight);
 
         // --- OPTION A: Target an Existing Snake (Near or On) ---
-        // We only do this if the roll is within the snake weights AND there are snakes alive
-        if (roll < (w_near + w_on) && !snakes.empty()) {
-             auto it = snakes.begin();
-             // Select a random snake
-             std::advance(it, NextRandom(snakes.size()));
-             Snake* s = it->second.get();
-             
-             int16_t sx = static_cast<int16_t>(s->get_head_x() / WorldConfig::sector_size);
-             int16_t sy = static_cast<int16_t>(s->get_head_y() / WorldConfig::sector_size);
-             
-             // Sub-selection: Neighbor vs Current
-             if (roll < w_near) {
-                 // 1. Target Neighbor Sector (Near Snake)
-                 // Pick a random offset (-1, 0, or 1)
-                 sx += (NextRandom(3) - 1);
-                 sy += (NextRandom(3) - 1);
-             } 
-             // Else: 2. Target Current Sector (On Snake) -> Keep sx, sy as is
-
-             // Validate Map Bounds
-             if (sx >= 0 && sx < WorldConfig::sector_count_along_edge &&
-                 sy >= 0 && sy < WorldConfig::sector_count_along_edge) {
-                 target_sector = sectors.get_sector(sx, sy);
-             }
+        // Only the sectors there that lack food are candidates.
+        if (roll < (w_near + w_on) && !tick_order.empty()) {
+             const Snake *s = tick_order[NextRandom(tick_order.size())];
+             target = PickFoodSectorAround(SectorSeq::get_coord(s->get_head_x()),
+                                           SectorSeq::get_coord(s->get_head_y()),
+                                           roll < w_near ? 1 : 0);
         }
 
         // --- OPTION B: Random Sector ---
-        // 3. Fallback to random if roll was high OR if targeting failed (e.g., bounds error)
-        if (target_sector == nullptr) {
-            int sec_idx = NextRandom(sectors.size());
-            target_sector = &sectors[sec_idx];
+        // Also the fallback when the snake's sectors are full
+        if (target < 0) {
+            target = static_cast<int32_t>(food_regen.Find(NextRandom(food_regen.get_total())));
         }
-        
-        // --- CAPACITY CHECK ---
-        // If this sector is already overfilled, skip this specific spawn attempt.
-        if (target_sector->food.size() >= target_sector->max_food_capacity) {
-            continue; 
+        Sector &sec = sectors[target];
+
+        // Generate position within the chosen sector, inside the circular
+        // map radius. Regrowing sectors have their center inside it, so a
+        // few tries are enough.
+        for (int tries = 0; tries < 4; tries++) {
+            uint16_t fx = sec.x * WorldConfig::sector_size + NextRandom<uint16_t>(WorldConfig::sector_size);
+            uint16_t fy = sec.y * WorldConfig::sector_size + NextRandom<uint16_t>(WorldConfig::sector_size);
+            float d_sq = Math::dist_sq(fx, fy, (float)WorldConfig::game_radius, (float)WorldConfig::game_radius);
+            if (d_sq > food_max_radius * food_max_radius) continue;
+
+            sec.Insert(Food{
+                fx, fy, 
+                static_cast<uint8_t>(1 + NextRandom<uint8_t>(5)), 
+                static_cast<uint8_t>(NextRandom<uint8_t>(29))
+            });
+            food_regen.Update(sec);
+            break;
         }
-
-        // Generate position within the chosen sector
-        uint16_t fx = target_sector->x * WorldConfig::sector_size + NextRandom<uint16_t>(WorldConfig::sector_size);
-        uint16_t fy = target_sector->y * WorldConfig::sector_size + NextRandom<uint16_t>(WorldConfig::sector_size);
-        
-        // Ensure food is inside the circular map radius
-        float d_sq = Math::dist_sq(fx, fy, (float)WorldConfig::game_radius, (float)WorldConfig::game_radius);
-        if (d_sq > (WorldConfig::game_radius - 500) * (WorldConfig::game_radius - 500)) continue;
-
-        // Insert the food
-        target_sector->Insert(Food{
-            fx, fy, 
-            static_cast<uint8_t>(1 + NextRandom<uint8_t>(5)), 
-            static_cast<uint8_t>(NextRandom<uint8_t>(29))
-        });
     }
 }
 
-void World::CheckSnakeBounds(Snake *s) {
-  static std::vector<snake_id_t> cs_cache;
-  cs_cache.clear();
+int32_t World::PickFoodSectorAround(int32_t sx, int32_t sy, int32_t around) {
+    uint32_t sum = 0;
+    SectorSeq::ForEachIndexAround(sx, sy, around, [&](size_t index) {
+        sum += food_regen.get_deficit(index);
+        return false;
+    });
+    if (sum == 0) {
+        return -1;
+    }
 
+    uint32_t pick = NextRandom(sum);
+    int32_t target = -1;
+    SectorSeq::ForEachIndexAround(sx, sy, around, [&](size_t index) {
+        const uint32_t d = food_regen.get_deficit(index);
+        if (pick < d) {
+            target = static_cast<int32_t>(index);
+            return true;
+        }
+        pick -= d;
+        return false;
+    });
+    return target;
+}
+
+void World::CheckSnakeBounds(uint32_t check, const Snake *s,
+                             std::vector<SnakeHit> *hits) const {
   float hx = s->get_head_x();
   float hy = s->get_head_y();
   
-  float move_dist = s->speed * WorldConfig::frame_time_ms / 1000.0f;
+  // far bots move in double steps, the swept head covers all of them
+  float move_dist = s->speed * WorldConfig::frame_time_ms / 1000.0f *
+                    static_cast<float>(Snake::get_move_steps(s->lod));
   if (move_dist < 5.0f) move_dist = 5.0f;
 
   float prev_hx = hx - cosf(s->angle) * move_dist;
@@ -292,60 +383,55 @@ void World::CheckSnakeBounds(Snake *s) {
 
   if (Math::dist_sq(tip_x, tip_y, (float)WorldConfig::game_radius, (float)WorldConfig::game_radius) >=
       WorldConfig::death_radius * WorldConfig::death_radius) {
-    s->update |= change_dying;
+    hits->push_back(SnakeHit{check, nullptr});
     return;
   }
 
-  int16_t sx = static_cast<int16_t>(hx / WorldConfig::sector_size);
-  int16_t sy = static_cast<int16_t>(hy / WorldConfig::sector_size);
-
-  for (int j = sy - 1; j <= sy + 1; j++) {
-    for (int i = sx - 1; i <= sx + 1; i++) {
-      if (i < 0 || i >= WorldConfig::sector_count_along_edge || 
-          j < 0 || j >= WorldConfig::sector_count_along_edge) continue;
+  const size_t first_hit = hits->size();
+  segments.ForEachNear(hx, hy, [&](const SegmentGrid::Chunk &chunk) {
+    const Snake *other = chunk.owner;
+    if (other == s || (other->update & (change_dying | change_dead))) return false;
+    if (other->parts.size() < 2) return false;
 
-      Sector *sec_ptr = sectors.get_sector(i, j);
-
-      for (const BoundBox *bb : sec_ptr->snakes) {
-        const Snake *other = bb->snake;
-        
-        if (other == s || (other->update & (change_dying|change_dead))) continue; // Skip dying snakes
-        
-        bool checked = false;
-        for(auto id : cs_cache) if(id == other->id) { checked = true; break; }
-        if(checked) continue;
-        cs_cache.push_back(other->id);
-
-        if (!s->sbb.Intersect(other->sbb)) continue;
-
-        float hit_r = (s->lsz/2.0f) + (other->lsz/2.0f);
-        float hit_dist_sq = hit_r * hit_r;
-
-        size_t len = other->parts.size();
-        if (len < 2) continue;
+    // any hit on an owner is enough, but every owner is needed as earlier
+    // checks may kill some of them
+    for (size_t i = first_hit; i < hits->size(); i++) {
+      if ((*hits)[i].owner == other) return false;
+    }
 
-        for (size_t k = 0; k < len - 1; ++k) {
-             const Body &b1 = other->parts[k];
-             const Body &b2 = other->parts[k+1];
+    const float hit_r = body_radius + chunk.r;
+    if (chunk.bound) {
+      const float reach = chunk.bound->r + hit_r + move_dist;
+      if (Math::dist_sq(hx, hy, chunk.bound->x, chunk.bound->y) >= reach * reach) {
+        return false;
+      }
+    }
+    if (Collision::HeadHitsBody(chunk.x, chunk.y, chunk.n, hx, hy, prev_hx, prev_hy,
+                                hit_r * hit_r)) {
+      hits->push_back(SnakeHit{check, other});
+    }
+    return false;
+  });
+}
 
-             if (Math::dist_sq(hx, hy, b1.x, b1.y) < hit_dist_sq) {
-                 s->update |= change_dying;
-                 return;
-             }
+void World::ApplySnakeHits() {
+  std::vector<SnakeHit> &all = hit_scratch[0];
+  for (size_t t = 1; t < hit_scratch.size(); t++) {
+    all.insert(all.end(), hit_scratch[t].begin(), hit_scratch[t].end());
+  }
+  if (hit_scratch.size() > 1) {
+    std::stable_sort(all.begin(), all.end(), [](const SnakeHit &a, const SnakeHit &b) {
+      return a.check < b.check;
+    });
+  }
 
-             if (Math::check_intersection(prev_hx, prev_hy, hx, hy, 
-                                          b1.x, b1.y, b2.x, b2.y)) {
-                 s->update |= change_dying;
-                 return;
-             }
-        }
-        
-        const Body &last = other->parts.back();
-        if (Math::dist_sq(hx, hy, last.x, last.y) < hit_dist_sq) {
-            s->update |= change_dying;
-            return;
-        }
-      }
+  // Same outcome as checking the snakes one after the other: a hit counts
+  // only if its owner was not killed by an earlier check.
+  for (const SnakeHit &hit : all) {
+    Snake *s = changes[hit.check];
+    if (s->update & change_dying) continue;
+    if (hit.owner == nullptr || !(hit.owner->update & (change_dying | change_dead))) {
+      s->update |= change_dying;
     }
   }
 }
@@ -353,10 +439,18 @@ void World::CheckSnakeBounds(Snake *s) {
 void World::Init(WorldConfig in_config) {
   config = in_config;
 
-  InitRandom();
   InitSectors();
+  danger.Init(spawn_min_radius, spawn_max_radius);
+  jobs.Start(config.sim_threads);
+  InitRandom();
+  if (config.deterministic) {
+    config.bot_ai_budget_us = 0;
+  }
+  bot_ai.set_time_budget_us(config.bot_ai_budget_us);
+  hit_scratch.resize(jobs.get_thread_count());
   InitFood();
 
+  snake_pool.Reserve(in_config.bots);
   SpawnNumSnakes(in_config.bots);
 }
 
@@ -389,12 +483,23 @@ void World::InitFood() {
                static_cast<uint8_t>(1 + NextRandom<uint8_t>(10)),
                NextRandom<uint8_t>(29)});
     }
-    s.Sort();
   }
+
+  food_regen.Init(&sectors, food_max_radius);
 }
 
 void World::AddSnake(Snake::Ptr ptr) {
-  snakes.insert({ptr->id, ptr});
+  segments.Update(ptr.get());
+  danger.Update(ptr.get());
+  if (snakes.insert({ptr->id, ptr}).second) {
+    tick_order.push_back(ptr.get());
+    if (ptr->bot) {
+      bot_ai.Add(ptr.get());
+    } else {
+      // bots near the spawn point must be at full detail before it looks
+      bot_lod.Invalidate();
+    }
+  }
 }
 
 void World::RemoveSnake(snake_id_t id) {
@@ -409,6 +514,10 @@ void World::RemoveSnake(snake_id_t id) {
     }
     */
 
+    segments.Remove(sn_i->second.get());
+    danger.Remove(sn_i->second.get());
+    bot_ai.Remove(sn_i->second.get());
+    tick_order.erase(std::find(tick_order.begin(), tick_order.end(), sn_i->second.get()));
     snakes.erase(id);
   }
 }
@@ -423,6 +532,10 @@ Ids &World::GetDead() { return dead; }
 
 std::vector<Snake *> &World::GetChangedSnakes() { return changes; }
 
+const SnakeVec &World::GetTickOrder() const { return tick_order; }
+
+JobSystem &World::GetJobs() { return jobs; }
+
 void World::FlushChanges() { changes.clear(); }
 
 void World::FlushChanges(snake_id_t id) {
@@ -439,6 +552,12 @@ void World::SpawnNumSnakes(const int count) {
 
 SectorSeq &World::GetSectors() { return sectors; }
 
+const SnakePool &World::GetSnakePool() const { return snake_pool; }
+
+const BotScheduler &World::GetBotScheduler() const { return bot_ai; }
+
+const BotLod &World::GetBotLod() const { return bot_lod; }
+
 std::ostream &operator<<(std::ostream &out, const World &w) {
   return out << "\tgame_radius = " << WorldConfig::game_radius
              << "\n\tmax_snake_parts = " << WorldConfig::max_snake_parts
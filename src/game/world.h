@@ -12,8 +12,27 @@ RELATIVE PATH: game/world.h
 #include <vector>
 #include <unordered_map>
 
+#include "game/bot_lod.h"
+#include "game/bot_scheduler.h"
+#include "game/danger_grid.h"
+#include "game/food_regen.h"
+#include "game/job_system.h"
+#include "game/random.h"
 #include "game/sector.h"
+#include "game/segment_grid.h"
+#include "game/sim_input.h"
 #include "game/snake.h"
+#include "game/snake_pool.h"
+
+// Wall time of the phases of the last frame World::Tick simulated, in
+// nanoseconds.
+struct TickPhases {
+  int64_t bot_ai = 0;     // BotScheduler::Tick
+  int64_t move = 0;       // Snake::TickMove, parallel
+  int64_t commit = 0;     // Snake::TickCommit and the spatial indexes
+  int64_t collision = 0;  // CheckSnakeBounds and ApplySnakeHits
+  int64_t food = 0;       // RegenerateFood
+};
 
 class World {
  public:
@@ -26,43 +45,110 @@ class World {
   Snake::Ptr CreateSnake(int start_len = 0);
   Snake::Ptr CreateSnakeBot();
   void SpawnNumSnakes(const int count);
-  void CheckSnakeBounds(Snake *s);
 
   void RegenerateFood(); 
 
+  // Seeds the world generator and one stream per simulation thread, after
+  // the job threads are started.
   void InitRandom();
   int NextRandom();
   float NextRandomf();
+  // Uniform in [0, base), base below 2^32.
   template <typename T>
   T NextRandom(T base);
+  // Seed in use, set or picked by InitRandom.
+  uint64_t GetSeed() const;
+  // Generator of the world, for the loop thread only.
+  Random& GetRandom();
+
+  // Applies a player command to its snake, if still alive.
+  void ApplyInput(const SimInput &in);
+
+  // Frames simulated since Init.
+  uint32_t GetFrame() const;
+  // Rolling hash of the state after each frame, deterministic mode only.
+  uint64_t GetFrameHash() const;
+  const TickPhases& GetTickPhases() const;
 
   void AddSnake(Snake::Ptr ptr);
   void RemoveSnake(snake_id_t id);
   SnakeMapIter GetSnake(snake_id_t id);
   SnakeMap& GetSnakes();
   SectorSeq& GetSectors();
+  const SnakePool& GetSnakePool() const;
+  const BotScheduler& GetBotScheduler() const;
+  const BotLod& GetBotLod() const;
   Ids& GetDead();
 
   SnakeVec& GetChangedSnakes();
+  const SnakeVec& GetTickOrder() const;
+  // Worker threads of the simulation, shared with the server tick.
+  JobSystem& GetJobs();
 
   void FlushChanges(snake_id_t id);
   void FlushChanges();
 
  private:
   void TickSnakes(long dt);
+  // Folds snake parts, angles and fullness in tick order, then the food
+  // count and value of every sector, into frame_hash.
+  void HashFrame();
+
+  // A moved snake dies on the map edge (owner nullptr) or on the body of an
+  // owner that is still alive when the hit is applied.
+  struct SnakeHit {
+    uint32_t check;  // index in changes
+    const Snake *owner;
+  };
+
+  // Read only, records the hits of changes[check] into *hits. Owners found
+  // dying here are skipped, owners killed later in the same frame are left
+  // to ApplySnakeHits.
+  void CheckSnakeBounds(uint32_t check, const Snake *s,
+                        std::vector<SnakeHit> *hits) const;
+  // Marks the snakes killed by the recorded hits, in changes order.
+  void ApplySnakeHits();
+  // Sector index for a regrown pellet aimed at the snake in sector (sx, sy),
+  // on it or within `around` sectors, weighted by deficit. -1 if all full.
+  int32_t PickFoodSectorAround(int32_t sx, int32_t sy, int32_t around);
   
-  // --- NEW: Helper to check for collisions before spawning ---
-  bool IsLocationSafe(float x, float y, float safety_radius);
+  // Spawn ring, from the center (avoid the dead center) to a buffer from
+  // the edge (prevent instant death).
+  static constexpr float spawn_min_radius = 1000.0f;
+  static constexpr float spawn_max_radius = WorldConfig::game_radius - 1500.0f;
+  // Seed of deterministic runs that set none.
+  static const uint64_t deterministic_seed = 1;
+  // Natural food stays this far inside the map.
+  static constexpr float food_max_radius = WorldConfig::game_radius - 500.0f;
 
  private:
+  // Declaration order matters on destruction: snakes return to the pool and
+  // unregister from their sectors, so both must outlive the snake map.
+  SnakePool snake_pool;
+  SectorSeq sectors;
   SnakeMap snakes;
   Ids dead;
-  SectorSeq sectors;
   SnakeVec changes;
+  SegmentGrid segments;
+  DangerGrid danger;
+  FoodRegen food_regen;
+  // snakes in the order they were added, the tick runs and commits them in
+  // this order
+  SnakeVec tick_order;
+  BotLod bot_lod;
+  BotScheduler bot_ai;
+  JobSystem jobs;
+  Random rng;
+  // per thread hits of the collision pass
+  std::vector<std::vector<SnakeHit>> hit_scratch;
+  static const size_t sim_grain = 16;
 
   uint16_t lastSnakeId = 0;
   long ticks = 0;
   uint32_t frames = 0;
+  uint64_t frame_hash = 0;
+  TickPhases phases;
+  uint64_t seed = 0;
 
   WorldConfig config;
 };
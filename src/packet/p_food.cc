@@ -1,5 +1,5 @@
 #include "packet/p_food.h"
-#include "server/config.h" 
+#include "game/config.h"
 
 static void get_sector_coords(uint16_t world_val, uint8_t& sector, uint8_t& rel) {
     uint16_t sec_size = WorldConfig::sector_size; 
@@ -9,11 +9,11 @@ std::ostream& operator<<(std::ostream& out, const packet_leaderboard& p) {
   // Byte 6-7: Player count
   out << write_uint16(p.players);
   
-  for (const auto& ptr : p.top) {
-    out << write_uint16(ptr->parts.size());
-    out << write_fp24(ptr->fullness / 100.0f);
-    out << write_uint8(ptr->skin); // Font color in docs, often mapped to skin or constant
-    out << write_string(ptr->name);
+  for (const packet_leaderboard::Entry& e : p.top) {
+    out << write_uint16(e.parts);
+    out << write_fp24(e.fullness / 100.0f);
+    out << write_uint8(e.skin); // Font color in docs, often mapped to skin or constant
+    out << write_string(e.name);
   }
   return out;
 }
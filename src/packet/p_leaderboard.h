@@ -1,7 +1,7 @@
 #ifndef SRC_PACKET_P_LEADERBOARD_H_
 #define SRC_PACKET_P_LEADERBOARD_H_
 
-#include <memory>
+#include <string>
 #include <vector>
 
 #include "game/snake.h"
@@ -10,6 +10,20 @@
 struct packet_leaderboard : public PacketBase {
   packet_leaderboard() : PacketBase(packet_t_leaderboard) {}
 
+  // Copied out of the snake, so the packet can be encoded without it.
+  struct Entry {
+    uint16_t parts;
+    uint16_t fullness;
+    uint8_t skin;
+    std::string name;
+
+    explicit Entry(const Snake *s)
+        : parts(static_cast<uint16_t>(s->parts.size())),
+          fullness(s->fullness),
+          skin(s->skin),
+          name(s->name) {}
+  };
+
   // local players rank in leaderboard (0 means not in leaderboard,
   // otherwise this is equal to the "local players rank".
   // Actually always redundant information)
@@ -25,13 +39,13 @@ struct packet_leaderboard : public PacketBase {
   ?-?	int8	username length
   ?-?	string	username
   */
-  std::vector<std::shared_ptr<Snake>> top;  // 2 + 3 + 1 + 1 string each
+  std::vector<Entry> top;  // 2 + 3 + 1 + 1 string each
 
   size_t get_size() const noexcept {
     size_t size = 8;
 
-    for (const auto& ptr : top) {
-      size += 2 + 3 + 1 + 1 + ptr->name.length();
+    for (const Entry& e : top) {
+      size += 2 + 3 + 1 + 1 + e.name.length();
     }
 
     return size;
@@ -47,7 +47,7 @@ std::ostream& operator<<(std::ostream& out, const packet_add_snake& p) {
   // 5. Body Parts
   if (!s->parts.empty()) {
     // Protocol sends the TAIL position in absolute coords first
-    const Body& tail = s->parts.back();
+    const Body tail = s->parts.back();
     float tx = tail.x;
     float ty = tail.y;
     
@@ -56,8 +56,8 @@ std::ostream& operator<<(std::ostream& out, const packet_add_snake& p) {
 
     // Then relative coords from Tail -> Head
     for (size_t i = s->parts.size() - 1; i > 0; --i) {
-        const Body& curr = s->parts[i];
-        const Body& next = s->parts[i-1]; // Moving towards head
+        const Body curr = s->parts[i];
+        const Body next = s->parts[i-1]; // Moving towards head
 
         float dx = next.x - curr.x;
         float dy = next.y - curr.y;
@@ -19,7 +19,17 @@ IncomingConfig ParseCommandLine(const int argc, const char *const *argv) {
       "port,p", po::value<uint16_t>(&config.port)->default_value(config.port),
       "bind port")("debug,d",
                    po::bool_switch(&config.debug)->default_value(config.debug),
-                   "enable debug mode");
+                   "enable debug mode")(
+      "profile", po::value<uint16_t>(&config.profile_secs)->default_value(config.profile_secs),
+      "log tick phase percentiles every N seconds, 0 = off; SIGUSR2 logs them at any time")(
+      "slow_tick", po::value<uint16_t>(&config.slow_tick_ms)->default_value(config.slow_tick_ms),
+      "dump the last ticks when one takes over N ms, 0 = off; SIGUSR1 dumps them at any time")(
+      "flight_dir", po::value<std::string>(&config.flight_dir)->default_value(config.flight_dir),
+      "directory of the tick dumps and traces")(
+      "trace_at", po::value<uint16_t>(&config.trace_at)->default_value(config.trace_at),
+      "capture a Chrome trace N seconds after start, 0 = off; SIGRTMIN+1 starts one at any time")(
+      "trace_secs", po::value<uint16_t>(&config.trace_secs)->default_value(config.trace_secs),
+      "length of a trace capture in seconds");
 
   po::options_description conf("Configuration");
     conf.add_options()
@@ -35,6 +45,21 @@ IncomingConfig ParseCommandLine(const int argc, const char *const *argv) {
         ("min_len", po::value<uint16_t>(&config.world.snake_min_length)
                        ->default_value(config.world.snake_min_length),
          "init snake min length")
+        ("threads", po::value<uint16_t>(&config.world.sim_threads)
+                       ->default_value(config.world.sim_threads),
+         "worker threads for the game tick (default: 1)")
+        ("ai_budget", po::value<uint32_t>(&config.world.bot_ai_budget_us)
+                       ->default_value(config.world.bot_ai_budget_us),
+         "bot AI time per frame in microseconds, 0 = no limit (default: 0)")
+        ("bot_lod", po::value<bool>(&config.world.bot_lod)
+                       ->default_value(config.world.bot_lod),
+         "simulate bots far from players with less detail (default: 1)")
+        ("seed", po::value<uint64_t>(&config.world.random_seed)
+                       ->default_value(config.world.random_seed),
+         "world random seed, 0 = from the clock (default: 0)")
+        ("deterministic", po::value<bool>(&config.world.deterministic)
+                       ->default_value(config.world.deterministic),
+         "fixed seed and frame time, log a state hash with the stats (default: 0)")
          
         // --- NEW FOOD SETTINGS ---
         ("food_rate", po::value<uint16_t>(&config.world.food_spawn_rate)
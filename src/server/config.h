@@ -3,6 +3,8 @@
 
 #include "game/config.h"
 
+#include <string>
+
 #include <websocketpp/config/asio_no_tls.hpp>
 // #include <websocketpp/extensions/permessage_deflate/enabled.hpp>
 
@@ -16,6 +18,11 @@ struct IncomingConfig {
   bool version = false;
   bool verbose = false;
   bool debug = false;
+  uint16_t profile_secs = 10;  // tick profile summary period, 0 = off
+  uint16_t slow_tick_ms = 50;  // dumps the flight recorder, 0 = off
+  std::string flight_dir = ".";
+  uint16_t trace_at = 0;  // seconds after start, 0 = off
+  uint16_t trace_secs = 5;
 
   WorldConfig world;
 };
@@ -0,0 +1,107 @@
+#include "server/flight_recorder.h"
+
+#include <cstdio>
+
+#include "game/trace.h"
+
+bool FlightRecorder::Dump(const std::string &path, const std::string &reason) const {
+  FILE *out = fopen(path.c_str(), "w");
+  if (out == nullptr) {
+    return false;
+  }
+
+  const uint64_t first = count > capacity ? count - capacity : 0;
+  fprintf(out, "# %s, ticks %llu to %llu, times in ms\n", reason.c_str(),
+          static_cast<unsigned long long>(first),
+          static_cast<unsigned long long>(count > 0 ? count - 1 : 0));
+  fprintf(out, "%-8s %-14s %3s", "tick", "time", "fr");
+  for (size_t p = 0; p < phase_count; p++) {
+    fprintf(out, " %9s", TickProfiler::get_phase_name(static_cast<tick_phase_t>(p)));
+  }
+  fprintf(out, " %6s %8s %7s %5s %5s %8s %9s %7s %4s\n", "snakes", "sessions", "changed",
+          "dead", "join", "packets", "bytes", "largest", "type");
+
+  for (uint64_t i = first; i < count; i++) {
+    const TickRecord &r = ring[i % capacity];
+    fprintf(out, "%-8llu %-14ld %3u", static_cast<unsigned long long>(i), r.time_ms,
+            r.frames);
+    for (size_t p = 0; p < phase_count; p++) {
+      fprintf(out, " %9.3f", r.phase_ns[p] / 1e6);
+    }
+    fprintf(out, " %6u %8u %7u %5u %5u %8llu %9llu %7u %4c\n", r.snakes, r.sessions,
+            r.changed, r.deaths, r.joins, static_cast<unsigned long long>(r.packets),
+            static_cast<unsigned long long>(r.bytes), r.largest_packet,
+            r.largest_packet > 0 ? static_cast<char>(r.largest_type) : '-');
+  }
+
+  return fclose(out) == 0;
+}
+
+const size_t FlightDumper::max_pending;
+
+FlightDumper::~FlightDumper() { Stop(); }
+
+void FlightDumper::Start(DoneFn fn) {
+  Stop();
+
+  done = fn;
+  stopping = false;
+  writer = std::thread(&FlightDumper::WriterLoop, this);
+}
+
+void FlightDumper::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  changed.notify_all();
+
+  if (writer.joinable()) {
+    writer.join();
+  }
+}
+
+bool FlightDumper::Queue(const FlightRecorder &recorder, const std::string &path,
+                         const std::string &reason) {
+  Job job{std::unique_ptr<FlightRecorder>(new FlightRecorder(recorder)), path, reason};
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (writer.joinable()) {
+      if (pending.size() >= max_pending) {
+        return false;
+      }
+      pending.push_back(std::move(job));
+    }
+  }
+  changed.notify_all();
+
+  // no writer running, write on the caller
+  if (job.recorder) {
+    Write(job);
+  }
+  return true;
+}
+
+void FlightDumper::WriterLoop() {
+  Tracer::SetThreadName("flight dumper");
+  for (;;) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      changed.wait(lock, [this] { return stopping || !pending.empty(); });
+      if (pending.empty()) {
+        return;
+      }
+      job = std::move(pending.front());
+      pending.pop_front();
+    }
+    Write(job);
+  }
+}
+
+void FlightDumper::Write(const Job &job) {
+  const bool ok = job.recorder->Dump(job.path, job.reason);
+  if (done) {
+    done(job.path, job.reason, ok);
+  }
+}
@@ -0,0 +1,93 @@
+#ifndef SRC_SERVER_FLIGHT_RECORDER_H_
+#define SRC_SERVER_FLIGHT_RECORDER_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "server/tick_profiler.h"
+
+// What one server tick did, filled in place by the game loop.
+struct TickRecord {
+  long time_ms;
+  int64_t phase_ns[phase_count];  // 0 for phases that did not run
+  uint32_t frames;
+  uint32_t snakes;
+  uint32_t sessions;
+  uint32_t changed;  // snakes with updates to send
+  uint32_t deaths;
+  uint32_t joins;    // snakes spawned, humans and bots
+  uint64_t packets;  // sent while the tick ran, by any thread
+  uint64_t bytes;
+  uint32_t largest_packet;
+  uint8_t largest_type;
+};
+
+// Ring of the last ticks, always on. Recording a tick is a copy of a few
+// counters into the next slot, the ring is only formatted by Dump.
+class FlightRecorder {
+ public:
+  // The slot for the next tick, overwriting the oldest one.
+  TickRecord *Next() { return &ring[count++ % capacity]; }
+
+  uint64_t get_count() const { return count; }
+
+  // Writes the recorded ticks, oldest first, as a text table.
+  bool Dump(const std::string &path, const std::string &reason) const;
+
+  static const size_t capacity = 512;
+
+ private:
+  TickRecord ring[capacity];
+  uint64_t count = 0;
+};
+
+// Writes dumps on a background thread, so the game loop only copies the
+// ring and never waits on the disk.
+class FlightDumper {
+ public:
+  // Called on the dump thread once a dump is written or failed.
+  typedef std::function<void(const std::string &path, const std::string &reason, bool ok)>
+      DoneFn;
+
+  FlightDumper() = default;
+  FlightDumper(const FlightDumper &) = delete;
+  FlightDumper &operator=(const FlightDumper &) = delete;
+  ~FlightDumper();
+
+  void Start(DoneFn fn);
+  // Writes the queued dumps and stops the thread.
+  void Stop();
+
+  // Copies the recorder to be written to path. False if max_pending dumps
+  // are still waiting, the copy is then dropped.
+  bool Queue(const FlightRecorder &recorder, const std::string &path,
+             const std::string &reason);
+
+  static const size_t max_pending = 4;
+
+ private:
+  struct Job {
+    std::unique_ptr<FlightRecorder> recorder;
+    std::string path;
+    std::string reason;
+  };
+
+  void WriterLoop();
+  void Write(const Job &job);
+
+  std::deque<Job> pending;
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::thread writer;
+  bool stopping = false;
+  DoneFn done;
+};
+
+#endif  // SRC_SERVER_FLIGHT_RECORDER_H_
@@ -1,10 +1,13 @@
 #include "server/game.h"
 
 #include <algorithm>
+#include <csignal>
+#include <ctime>
 #include <iomanip>
 #include <sstream>
 
 #include "game/math.h"
+#include "game/trace.h"
 
 
 // ANSI color codes for terminal output
@@ -40,6 +43,9 @@ GameServer::GameServer() {
   // Initialize the Asio transport policy
   endpoint.init_asio();
   endpoint.set_reuse_addr(true);
+  // The transport's own default is a backlog of 0, which drops the SYNs of
+  // clients connecting at the same time; they retry a second later.
+  endpoint.set_listen_backlog(boost::asio::socket_base::max_connections);
 
   // Bind the handlers we are using
   endpoint.set_socket_init_handler(bind(&GameServer::on_socket_init, this, ::_1, ::_2));
@@ -47,6 +53,8 @@ GameServer::GameServer() {
   endpoint.set_open_handler(bind(&GameServer::on_open, this, _1));
   endpoint.set_message_handler(bind(&GameServer::on_message, this, _1, _2));
   endpoint.set_close_handler(bind(&GameServer::on_close, this, _1));
+  endpoint.set_http_handler(bind(&GameServer::on_http, this, _1));
+  endpoint.set_metrics(&metrics);
 }
 
 int GameServer::Run(IncomingConfig in_config) {
@@ -59,12 +67,34 @@ int GameServer::Run(IncomingConfig in_config) {
   endpoint.start_accept();
 
   world.Init(in_config.world);
+  endpoint.get_alog().write(alevel::app, "Random seed " + std::to_string(world.GetSeed()));
   init = BuildInitPacket();
+  signals.reset(new boost::asio::signal_set(endpoint.get_io_service(), SIGUSR1, SIGUSR2));
+  // SIGPROF belongs to profilers, a real-time signal starts traces
+  signals->add(SIGRTMIN + 1);
+  WaitSignal();
+  Tracer::SetThreadName("io and game loop");
+  if (config.trace_at > 0) {
+    trace_timer = endpoint.set_timer(config.trace_at * 1000L,
+                                     bind(&GameServer::on_trace_timer, this, _1));
+  }
+  last_profile_time = GetCurrentTime();
+  pipeline.Start([this](const UpdateSnapshot &snapshot) { SendUpdates(snapshot); });
+  dumper.Start([this](const std::string &path, const std::string &reason, bool ok) {
+    if (ok) {
+      endpoint.get_alog().write(alevel::app, "Flight recorder (" + reason + ") dumped to " + path);
+    } else {
+      endpoint.get_alog().write(alevel::app, "Cannot write flight recorder dump " + path);
+    }
+  });
   NextTick(GetCurrentTime());
 
   try {
     endpoint.get_alog().write(alevel::app, "Server started...");
     endpoint.run();
+    Tracer::Stop();
+    pipeline.Stop();
+    dumper.Stop();
     return 0;
   } catch (websocketpp::exception const &e) {
     std::cout << e.what() << std::endl;
@@ -72,16 +102,163 @@ int GameServer::Run(IncomingConfig in_config) {
   }
 }
 
+void GameServer::PrintProfile(bool with_total) {
+  std::stringstream s;
+  s << "Tick profile, last " << (GetCurrentTime() - last_profile_time) / 1000.0 << "s:\n";
+  profiler.PrintWindow(s);
+  if (with_total) {
+    s << "\nTick profile since start:\n";
+    profiler.PrintTotal(s);
+  }
+  endpoint.get_alog().write(alevel::app, s.str());
+}
+
+void GameServer::PublishMetrics() {
+  TraceScope trace("GameServer::PublishMetrics");
+  ServerMetrics::Gauges g;
+  for (const auto &pair : world.GetSnakes()) {
+    if (pair.second->bot) {
+      g.bots++;
+    } else {
+      g.humans++;
+    }
+  }
+  for (const Sector &sector : world.GetSectors()) {
+    g.food += sector.food.size();
+  }
+
+  for (const auto &pair : sessions) {
+    if (pair.second.snake_id == 0) {
+      g.sessions_connecting++;
+    } else if (pair.second.is_modern_protocol()) {
+      g.sessions_modern++;
+    } else {
+      g.sessions_legacy++;
+    }
+
+    error_code ec;
+    const WSPPServer::connection_ptr con = endpoint.get_con_from_hdl(pair.first, ec);
+    if (!ec) {
+      const uint64_t queued = con->get_buffered_amount();
+      g.send_queue_bytes += queued;
+      g.send_queue_max_bytes = std::max(g.send_queue_max_bytes, queued);
+    }
+  }
+
+  const SnakePool &pool = world.GetSnakePool();
+  g.pool_in_use = pool.get_in_use();
+  g.pool_free = pool.get_free();
+  g.pool = pool.get_stats();
+  metrics.Publish(g);
+}
+
+void GameServer::RecordTick(long now, uint32_t frames) {
+  TickRecord *r = recorder.Next();
+  r->time_ms = now;
+  for (size_t p = 0; p < phase_count; p++) {
+    r->phase_ns[p] = profiler.get_last(static_cast<tick_phase_t>(p));
+  }
+  r->frames = frames;
+  r->snakes = static_cast<uint32_t>(world.GetSnakes().size());
+  r->sessions = static_cast<uint32_t>(sessions.size());
+  r->changed = tick_changed;
+  r->deaths = tick_deaths;
+  r->joins = tick_joins;
+  metrics.TakeTickSends(r);
+  tick_changed = 0;
+  tick_deaths = 0;
+  tick_joins = 0;
+}
+
+void GameServer::DumpFlightRecorder(const std::string &reason) {
+  char stamp[32];
+  const time_t t = time(nullptr);
+  strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", localtime(&t));
+  const std::string path = config.flight_dir + "/flight-" + stamp + "-" +
+                           std::to_string(recorder.get_count()) + ".txt";
+  if (!dumper.Queue(recorder, path, reason)) {
+    endpoint.get_alog().write(alevel::app, "Flight recorder (" + reason + ") skipped, " +
+                                               std::to_string(FlightDumper::max_pending) +
+                                               " dumps still being written");
+  }
+}
+
+void GameServer::StartTrace() {
+  char stamp[32];
+  const time_t t = time(nullptr);
+  strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", localtime(&t));
+  const std::string path = config.flight_dir + "/trace-" + stamp + ".json";
+  if (Tracer::Start(path, config.trace_secs * 1000L)) {
+    endpoint.get_alog().write(alevel::app, "Tracing " + std::to_string(config.trace_secs) +
+                                               "s to " + path);
+  } else {
+    endpoint.get_alog().write(alevel::app, "Cannot start a trace to " + path +
+                                               ", one is running or the file is not writable");
+  }
+}
+
+void GameServer::on_trace_timer(error_code const &ec) {
+  if (!ec) {
+    StartTrace();
+  }
+}
+
+void GameServer::on_http(connection_hdl hdl) {
+  const WSPPServer::connection_ptr con = endpoint.get_con_from_hdl(hdl);
+  if (con->get_resource() != "/metrics") {
+    con->set_status(websocketpp::http::status_code::not_found);
+    return;
+  }
+
+  std::stringstream s;
+  metrics.Write(s);
+  con->set_body(s.str());
+  con->append_header("Content-Type", "text/plain; version=0.0.4");
+  con->set_status(websocketpp::http::status_code::ok);
+}
+
+void GameServer::WaitSignal() {
+  signals->async_wait(bind(&GameServer::on_signal, this, _1, _2));
+}
+
+void GameServer::on_signal(boost::system::error_code const &ec, int signo) {
+  if (ec) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(game_mutex);
+  if (signo == SIGUSR1) {
+    DumpFlightRecorder("SIGUSR1");
+  } else if (signo == SIGUSR2) {
+    PrintProfile(true);
+  } else if (signo == SIGRTMIN + 1) {
+    StartTrace();
+  }
+  WaitSignal();
+}
+
 void GameServer::PrintWorldInfo() {
   std::stringstream s;
   s << "World info = \n" << world;
   endpoint.get_alog().write(alevel::app, s.str());
 }
 
+void GameServer::PrintStats() {
+  std::stringstream s;
+  s << world.GetSnakePool() << "\n" << world.GetBotScheduler() << "\n"
+    << world.GetBotLod();
+  if (config.world.deterministic) {
+    s << "\nframe " << world.GetFrame() << " hash " << std::hex << world.GetFrameHash();
+  }
+  endpoint.get_alog().write(alevel::app, s.str());
+}
+
 void GameServer::NextTick(long last) {
+  // the world steps one frame per tick in deterministic mode
+  const long interval = config.world.deterministic ? WorldConfig::frame_time_ms
+                                                   : timer_interval_ms;
   last_time_point = last;
   timer = endpoint.set_timer(
-      std::max(0L, timer_interval_ms - (GetCurrentTime() - last)),
+      std::max(0L, interval - (GetCurrentTime() - last)),
       bind(&GameServer::on_timer, this, _1));
 }
 
@@ -96,10 +273,136 @@ void GameServer::on_timer(error_code const &ec) {
         "Main game loop timer error: " + ec.message());
     return;
   }
+  TraceScope trace("GameServer::on_timer");
+
+  // The tick as a graph of jobs on the world's worker threads. A job
+  // depends on the earlier jobs whose data it touches, so a single thread
+  // runs them in the order they are added.
+  JobGraph &g = tick_graph;
+  g.Clear();
+  profiler.BeginTick();
+  const auto tick_start = std::chrono::steady_clock::now();
+  TickProfiler *prof = &profiler;
+  const uint32_t frame = world.GetFrame();
+
+  const JobGraph::JobId tick = g.Add([this, dt, prof] {
+    TickProfiler::Scope scope(prof, phase_world);
+    world.Tick(dt);
+  });
+  const JobGraph::JobId respawn = g.Add([this, prof] {
+    TickProfiler::Scope scope(prof, phase_spawn);
+    RespawnBots();
+  }, {tick});
+  const JobGraph::JobId grow = g.Add([this, prof] {
+    TickProfiler::Scope scope(prof, phase_spawn);
+    GrowSpawningSnakes();
+  }, {respawn});
+  const JobGraph::JobId debug = g.Add([this, prof] {
+    TickProfiler::Scope scope(prof, phase_broadcast);
+    BroadcastDebug();
+  }, {grow});
+  const JobGraph::JobId updates = g.Add([this, prof] {
+    TickProfiler::Scope scope(prof, phase_broadcast);
+    BroadcastUpdates();
+  }, {debug});
+  const JobGraph::JobId remove = g.Add([this, prof] {
+    TickProfiler::Scope scope(prof, phase_cleanup);
+    RemoveDeadSnakes();
+  }, {updates});
+
+  // The world is read only from here on, only the collects share the
+  // sessions and the snapshot.
+  JobGraph::JobId sessions_done = g.Add([this, prof] {
+    TickProfiler::Scope scope(prof, phase_cleanup);
+    CleanupDeadSessions();
+  }, {remove});
 
-  world.Tick(dt);
+  // Broadcast Leaderboard (Every 2 seconds)
+  if (now - last_leaderboard_time > 2000) {
+      const JobGraph::JobId build = g.Add([this, prof] {
+        TickProfiler::Scope scope(prof, phase_leaderboard);
+        BuildLeaderboard();
+      }, {remove});
+      sessions_done = g.Add([this, prof] {
+        TickProfiler::Scope scope(prof, phase_leaderboard);
+        CollectLeaderboard(tick_snapshot);
+      }, {build, sessions_done});
+      last_leaderboard_time = now;
+  }
 
-  // --- Bot Spawning ---
+  // Broadcast Minimap (Every 1 second)
+  if (now - last_minimap_time > 1000) {
+      const JobGraph::JobId build = g.Add([this, prof] {
+        TickProfiler::Scope scope(prof, phase_minimap);
+        BuildMinimap();
+      }, {remove});
+      sessions_done = g.Add([this, prof] {
+        TickProfiler::Scope scope(prof, phase_minimap);
+        CollectMinimap(tick_snapshot);
+      }, {build, sessions_done});
+      last_minimap_time = now;
+  }
+
+  sessions_done = g.Add([this, prof] {
+    TickProfiler::Scope scope(prof, phase_broadcast);
+    PublishUpdates();
+  }, {sessions_done});
+
+  // Metrics gauges (Every second)
+  if (now - last_metrics_time >= 1000) {
+      g.Add([this] { PublishMetrics(); }, {sessions_done});
+      last_metrics_time = now;
+  }
+
+  // Log allocator statistics (Every minute)
+  if (now - last_stats_time > 60000) {
+      g.Add([this] { PrintStats(); }, {remove});
+      last_stats_time = now;
+  }
+
+  world.GetJobs().Run(&g);
+
+  if (world.GetFrame() != frame) {
+    profiler.AddWorldPhases(world.GetTickPhases());
+  }
+  profiler.Add(phase_tick, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now() - tick_start).count());
+  profiler.EndTick();
+  // A late tick simulates the missed frames as one longer step.
+  const uint32_t frames = world.GetFrame() - frame;
+  const uint32_t on_time_frames =
+      (timer_interval_ms + WorldConfig::frame_time_ms - 1) / WorldConfig::frame_time_ms;
+  metrics.RecordTick(profiler, frames, frames > on_time_frames ? frames - on_time_frames : 0);
+  RecordTick(now, frames);
+
+  const int64_t step_ns = profiler.get_last(phase_tick);
+  if (step_ns > timer_interval_ms * 1000000) {
+    std::stringstream s;
+    s << "Load is too high, step took " << std::fixed << std::setprecision(3)
+      << step_ns / 1e6 << "ms: ";
+    profiler.PrintLast(s);
+    endpoint.get_alog().write(alevel::app, s.str());
+  }
+
+  // One dump per slow tick burst, each with a full ring of fresh ticks.
+  if (config.slow_tick_ms > 0 && step_ns > config.slow_tick_ms * 1000000L &&
+      recorder.get_count() >= next_slow_dump) {
+    DumpFlightRecorder("tick took " + std::to_string(step_ns / 1000000) + "ms");
+    next_slow_dump = recorder.get_count() + FlightRecorder::capacity;
+  }
+
+  // Tick phase percentiles (Every --profile seconds)
+  if (config.profile_secs > 0 && now - last_profile_time >= config.profile_secs * 1000L) {
+    PrintProfile(false);
+    profiler.ResetWindow();
+    last_profile_time = now;
+  }
+
+  NextTick(now);
+}
+
+void GameServer::RespawnBots() {
+  TraceScope trace("GameServer::RespawnBots");
   if (config.world.bot_respawn) {
       int active_bots = 0;
       for (auto &pair : world.GetSnakes()) {
@@ -111,11 +414,16 @@ void GameServer::on_timer(error_code const &ec) {
            SpawnBot();
       }
   }
+}
+
+// --- FIX: Faster Spawn Animation ---
+void GameServer::GrowSpawningSnakes() {
+  TraceScope trace("GameServer::GrowSpawningSnakes");
+  const SnakeVec &snakes = world.GetTickOrder();
+  world.GetJobs().ParallelFor(snakes.size(), snake_job_grain, [&snakes](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      Snake *s = snakes[i];
 
-  // --- FIX: Faster Spawn Animation ---
-  for (auto &pair : world.GetSnakes()) {
-      Snake *s = pair.second.get();
-      
       // If snake is smaller than target size (spawning phase)
       if (s->parts.size() < s->target_score) {
           // Increase growth rate: 
@@ -125,33 +433,8 @@ void GameServer::on_timer(error_code const &ec) {
           s->IncreaseSnake(50); 
           s->update |= change_fullness | change_pos;
       }
-  }
-
-  BroadcastDebug();
-  BroadcastUpdates();
-  RemoveDeadSnakes();
-
-  CleanupDeadSessions();
-
-  // Broadcast Leaderboard (Every 2 seconds)
-  if (now - last_leaderboard_time > 2000) {
-      BroadcastLeaderboard();
-      last_leaderboard_time = now;
-  }
-
-  // Broadcast Minimap (Every 1 second)
-  if (now - last_minimap_time > 1000) {
-      BroadcastMinimap();
-      last_minimap_time = now;
-  }
-
-  const long step_time = GetCurrentTime() - now;
-  if (step_time > 10) {
-    endpoint.get_alog().write(alevel::app,
-        "Load is too high, step took " + std::to_string(step_time) + "ms");
-  }
-
-  NextTick(now);
+    }
+  });
 }
 
 void GameServer::BroadcastDebug() {
@@ -174,7 +457,7 @@ void GameServer::BroadcastDebug() {
     draw.circles.push_back(
         d_draw_circle{sis++, {s->get_head_x(), s->get_head_y()}, r1, 0xc80000});
 
-    const Body &sec = *(s->parts.begin() + 1);
+    const Body sec = s->parts[1];
     draw.circles.push_back(d_draw_circle{sis++, {sec.x, sec.y}, r1, 0x3c3c3c});
     draw.circles.push_back(
         d_draw_circle{sis++,
@@ -227,36 +510,22 @@ void GameServer::BroadcastDebug() {
   }
 }
 
-// ----------------------------------------------------------------------------
-// UPDATED SendFoodUpdate (Hybrid Protocol Support)
-// ----------------------------------------------------------------------------
-void GameServer::SendFoodUpdate(Snake *ptr) {
+// Food eaten and spawned by ptr this tick, encoded per player version when sent.
+void GameServer::CollectFoodUpdate(Snake *ptr, UpdateSnapshot *snapshot) {
   // 1. Handle Eaten Food
   if (!ptr->eaten.empty()) {
     const snake_id_t id = ptr->id;
-
-    for (auto &s : sessions) {
-        if (s.second.snake_id == 0) continue;
-
-        // Get the specific version for this player
-        uint8_t ver = s.second.protocol_version;
-        
-        for (const auto &f : ptr->eaten) {
-            // Send constructed packet
-            endpoint.send_binary(s.first, packet_eat_food(id, Food(f.x, f.y, f.size, f.color), ver));
-        }
+    for (const auto &f : ptr->eaten) {
+        // The packet depends on each player's version, built when sent
+        snapshot->AddEatenFood(id, Food(f.x, f.y, f.size, f.color));
     }
     ptr->eaten.clear();
   }
 
   // 2. Handle Spawned Food
   if (!ptr->spawn.empty()) {
-    for (auto &s : sessions) {
-        if (s.second.snake_id == 0) continue;
-        bool is_modern = s.second.is_modern_protocol();
-        for (const Food &f : ptr->spawn) {
-             endpoint.send_binary(s.first, packet_spawn_food(f, is_modern));
-        }
+    for (const Food &f : ptr->spawn) {
+        snapshot->AddSpawnedFood(f);
     }
     ptr->spawn.clear();
   }
@@ -266,6 +535,7 @@ void GameServer::SendFoodUpdate(Snake *ptr) {
 // NEW CleanupDeadSessions
 // ----------------------------------------------------------------------------
 void GameServer::CleanupDeadSessions() {
+  TraceScope trace("GameServer::CleanupDeadSessions");
     const long now = GetCurrentTime();
     std::vector<connection_hdl> to_close;
     
@@ -278,8 +548,8 @@ void GameServer::CleanupDeadSessions() {
                 to_close.push_back(it->first);
                 
                 // CRITICAL FIX: Mark ID as 0 immediately.
-                // This prevents BroadcastLeaderboard/Minimap from trying 
-                // to send data to this socket while it's closing, 
+                // This prevents CollectLeaderboard/CollectMinimap from
+                // queueing data for this socket while it's closing,
                 // which stops the "invalid state" errors.
                 ss.snake_id = 0; 
             }
@@ -297,6 +567,25 @@ void GameServer::CleanupDeadSessions() {
 // UPDATED BroadcastUpdates
 // ----------------------------------------------------------------------------
 void GameServer::BroadcastUpdates() {
+  TraceScope trace("GameServer::BroadcastUpdates");
+  tick_snapshot = pipeline.Acquire();
+  CollectUpdates(tick_snapshot);
+}
+
+void GameServer::PublishUpdates() {
+  pipeline.Publish(tick_snapshot);
+  tick_snapshot = nullptr;
+}
+
+void GameServer::CollectUpdates(UpdateSnapshot *snapshot) {
+  for (auto &s : sessions) {
+    s.second.recipient = static_cast<uint32_t>(snapshot->recipients.size());
+    snapshot->recipients.push_back(UpdateSnapshot::Recipient{
+        s.first, s.second.last_packet_time, s.second.snake_id,
+        s.second.protocol_version, s.second.is_modern_protocol()});
+  }
+  const uint32_t to_all = UpdateSnapshot::to_all;
+
   // Use a copy to safely iterate if map changes (though removal is deferred to RemoveDeadSnakes)
   auto changed_snakes = world.GetChangedSnakes();
 
@@ -312,27 +601,21 @@ void GameServer::BroadcastUpdates() {
 
       // 1. Spawn Food (CRITICAL: Must be first so clients see the food generated)
       if (world.GetSnake(id) != world.GetSnakes().end()) {
-          ptr->on_dead_food_spawn(&world.GetSectors(), [&]() -> float {
-            return world.NextRandomf();
-          });
-          SendFoodUpdate(ptr);
+          ptr->on_dead_food_spawn(&world.GetSectors(), &world.GetRandom());
+          CollectFoodUpdate(ptr, snapshot);
       }
 
       // 2. Broadcast Removal ('s') to EVERYONE.
       // Status 1 = Died (Explosion Animation).
-      broadcast_binary(packet_remove_snake(id, packet_remove_snake::status_snake_died));
+      snapshot->Add(to_all, packet_remove_snake(id, packet_remove_snake::status_snake_died));
 
       // 3. Send Game Over ('v') ONLY to the victim.
       // This is sent last because the client might disconnect immediately upon receiving 'v'.
       if (!ptr->bot) {
         const auto ses_i = LoadSessionIter(id);
         if (ses_i != sessions.end()) {
-          try {
-            send_binary(ses_i, packet_end(packet_end::status_death));
-            ses_i->second.death_timestamp = GetCurrentTime();
-          } catch (...) {
-             // Swallow errors if client disconnected
-          }
+          snapshot->Add(ses_i->second.recipient, packet_end(packet_end::status_death));
+          ses_i->second.death_timestamp = GetCurrentTime();
         }
       }
 
@@ -359,30 +642,30 @@ void GameServer::BroadcastUpdates() {
           ptr->update ^= change_speed;
           rot.snakeSpeed = ptr->speed / 32.0f;
         }
-        broadcast_binary(rot);
+        snapshot->Add(to_all, rot);
       }
 
       if (flags & change_pos) {
         ptr->update ^= change_pos;
         if (ptr->clientPartsIndex < ptr->parts.size()) {
-          broadcast_binary(packet_inc(ptr));
+          snapshot->Add(to_all, packet_inc(ptr));
           ptr->clientPartsIndex++;
         } else {
           if (ptr->clientPartsIndex > ptr->parts.size()) {
-            broadcast_binary(packet_remove_part(ptr));
+            snapshot->Add(to_all, packet_remove_part(ptr));
             ptr->clientPartsIndex--;
           }
-          broadcast_binary(packet_move(ptr));
+          snapshot->Add(to_all, packet_move(ptr));
         }
 
-        SendFoodUpdate(ptr);
+        CollectFoodUpdate(ptr, snapshot);
         
         if (!ptr->bot && !(ptr->update & change_dying)) {
           const auto ses_i = LoadSessionIter(id);
           if (ses_i != sessions.end() && ses_i->second.death_timestamp == 0) {
-              SendPOVUpdateTo(ses_i, ptr);
+              CollectPOVUpdate(ses_i->second.recipient, ptr, snapshot);
               if (flags & change_fullness) {
-                send_binary(ses_i, packet_fullness(ptr));
+                snapshot->Add(ses_i->second.recipient, packet_fullness(ptr));
                 ptr->update ^= change_fullness;
               }
           }
@@ -391,12 +674,96 @@ void GameServer::BroadcastUpdates() {
     }
   }
 
+  tick_changed = static_cast<uint32_t>(world.GetChangedSnakes().size());
   world.FlushChanges();
 }
 
-void GameServer::BroadcastLeaderboard() {
+// Runs on the pipeline's sender thread, without the game lock.
+void GameServer::SendUpdates(const UpdateSnapshot &snapshot) {
+  TraceScope trace("GameServer::SendUpdates");
+  for (const UpdateSnapshot::Update &u : snapshot.updates) {
+    if (u.to != UpdateSnapshot::to_all) {
+      SendUpdate(snapshot, u, snapshot.recipients[u.to]);
+      continue;
+    }
+    for (const UpdateSnapshot::Recipient &r : snapshot.recipients) {
+      if (r.snake_id == 0) continue;
+      SendUpdate(snapshot, u, r);
+    }
+  }
+}
+
+void GameServer::SendUpdate(const UpdateSnapshot &snapshot,
+                            const UpdateSnapshot::Update &u,
+                            const UpdateSnapshot::Recipient &r) {
+  switch (u.kind) {
+    case update_rotation:
+      send_timed(r, snapshot.rotations[u.index]);
+      break;
+    case update_inc:
+      send_timed(r, snapshot.incs[u.index]);
+      break;
+    case update_move:
+      send_timed(r, snapshot.moves[u.index]);
+      break;
+    case update_remove_part:
+      send_timed(r, snapshot.remove_parts[u.index]);
+      break;
+    case update_fullness:
+      send_timed(r, snapshot.fullness[u.index]);
+      break;
+    case update_remove_snake:
+      send_timed(r, snapshot.remove_snakes[u.index]);
+      break;
+    case update_end:
+      try {
+        send_timed(r, snapshot.ends[u.index]);
+      } catch (...) {
+        // Swallow errors if client disconnected
+      }
+      break;
+    case update_add_sector:
+      send_timed(r, snapshot.add_sectors[u.index]);
+      break;
+    case update_remove_sector:
+      send_timed(r, snapshot.remove_sectors[u.index]);
+      break;
+    case update_set_food:
+      // HYBRID CHECK
+      if (r.is_modern) {
+          send_timed(r, packet_set_food_rel(&snapshot.sector_food[u.index]));
+      } else {
+          send_timed(r, packet_set_food_abs(&snapshot.sector_food[u.index]));
+      }
+      break;
+    case update_eat_food: {
+      const UpdateSnapshot::EatenFood &e = snapshot.eaten[u.index];
+      endpoint.send_binary(r.hdl, packet_eat_food(e.snake_id, e.food, r.protocol_version));
+      break;
+    }
+    case update_spawn_food:
+      endpoint.send_binary(r.hdl, packet_spawn_food(snapshot.spawned[u.index], r.is_modern));
+      break;
+    case update_leaderboard: {
+      packet_leaderboard lb_packet = snapshot.leaderboard;
+      lb_packet.local_rank = snapshot.leaderboard_ranks[u.index];
+      // leaderboard_rank is usually 0 unless you are IN the top 10
+      lb_packet.leaderboard_rank =
+          lb_packet.local_rank <= 10 ? static_cast<uint8_t>(lb_packet.local_rank) : 0;
+      send_timed(r, lb_packet);
+      break;
+    }
+    case update_minimap:
+      send_timed(r, r.is_modern ? snapshot.minimap_rev : snapshot.minimap_fwd);
+      break;
+  }
+}
+
+void GameServer::BuildLeaderboard() {
+  TraceScope trace("GameServer::BuildLeaderboard");
   // 1. Collect all snakes
-  std::vector<std::shared_ptr<Snake>> sorted_snakes;
+  std::vector<std::shared_ptr<Snake>> &sorted_snakes = leaderboard_snakes;
+  sorted_snakes.clear();
   for (auto &pair : world.GetSnakes()) {
     sorted_snakes.push_back(pair.second);
   }
@@ -408,46 +775,48 @@ void GameServer::BroadcastLeaderboard() {
   });
 
   // 3. Prepare the Top 10 list (Base Packet)
-  packet_leaderboard lb_base;
+  packet_leaderboard &lb_base = leaderboard_base;
+  lb_base.top.clear();
   lb_base.players = static_cast<uint16_t>(sorted_snakes.size());
   
   size_t top_count = std::min((size_t)10, sorted_snakes.size());
   for(size_t i = 0; i < top_count; i++) {
-      lb_base.top.push_back(sorted_snakes[i]);
+      lb_base.top.emplace_back(sorted_snakes[i].get());
   }
 
-  // 4. Send to each player individually using Iterator
-  for (auto it = sessions.begin(); it != sessions.end(); ++it) {
-      Session &sess = it->second;
-
-      // Skip players who haven't spawned yet (snake_id 0)
-      if (sess.snake_id == 0) continue;
-
-      // Find this player's rank
-      uint16_t my_rank = 0;
-      for(size_t i = 0; i < sorted_snakes.size(); i++) {
-          if(sorted_snakes[i]->id == sess.snake_id) {
-              my_rank = i + 1;
-              break;
-          }
+  // 4. Rank of each player
+  leaderboard_ranks.clear();
+  for (size_t i = 0; i < sorted_snakes.size(); i++) {
+      if (!sorted_snakes[i]->bot) {
+          leaderboard_ranks[sorted_snakes[i]->id] = static_cast<uint16_t>(i + 1);
       }
+  }
+}
 
-      // Copy base packet and add specific rank data
-      packet_leaderboard lb_packet = lb_base;
-      lb_packet.local_rank = my_rank;
-      // leaderboard_rank is usually 0 unless you are IN the top 10
-      lb_packet.leaderboard_rank = (my_rank <= 10) ? (uint8_t)my_rank : 0;
+void GameServer::CollectLeaderboard(UpdateSnapshot *snapshot) {
+  TraceScope trace("GameServer::CollectLeaderboard");
+  snapshot->leaderboard = leaderboard_base;
+
+  // 5. One entry per player, with their rank (0 if their snake is gone)
+  for (auto &s : sessions) {
+      // Skip players who haven't spawned yet (snake_id 0)
+      if (s.second.snake_id == 0) continue;
 
-      // FIX: Pass the iterator 'it' to send_binary
-      send_binary(it, lb_packet);
+      const auto rank = leaderboard_ranks.find(s.second.snake_id);
+      snapshot->AddLeaderboard(s.second.recipient,
+                               rank != leaderboard_ranks.end() ? rank->second : 0);
   }
+
+  leaderboard_snakes.clear();
+  leaderboard_base.top.clear();
 }
 
-void GameServer::BroadcastMinimap() {
+void GameServer::BuildMinimap() {
+  TraceScope trace("GameServer::BuildMinimap");
   // 1. Define Map Grid Size
   // Original is 80. You can increase this (e.g. 144) for C clients if desired,
   // but JS clients strictly expect 80x80 data in 'u' packets.
-  const uint16_t map_dim = 144;
+  const uint16_t map_dim = minimap_dim;
   
   std::vector<uint8_t> grid(map_dim * map_dim, 0);
 
@@ -459,7 +828,7 @@ void GameServer::BroadcastMinimap() {
     if (s->parts.empty() || (s->update & change_dead)) continue;
 
     for (size_t i = 0; i < s->parts.size(); i += 4) {
-      const Body& b = s->parts[i];
+      const Body b = s->parts[i];
       int mx = static_cast<int>(b.x * scale);
       int my = static_cast<int>(b.y * scale);
       if (mx >= 0 && mx < map_dim && my >= 0 && my < map_dim) {
@@ -471,7 +840,8 @@ void GameServer::BroadcastMinimap() {
   // ---------------------------------------------------------
   // A. Build Forward Packet ('u') for JS Clients
   // ---------------------------------------------------------
-  packet_minimap packet_fwd(map_dim);
+  packet_minimap &packet_fwd = minimap_fwd;
+  packet_fwd.data.clear();
   packet_fwd.packet_type = packet_t_minimap_legacy; // 'u'
   
   int skip = 0;
@@ -501,7 +871,8 @@ void GameServer::BroadcastMinimap() {
   // ---------------------------------------------------------
   // B. Build Reverse Packet ('M') for C Clients
   // ---------------------------------------------------------
-  packet_minimap packet_rev(map_dim);
+  packet_minimap &packet_rev = minimap_rev;
+  packet_rev.data.clear();
   packet_rev.packet_type = packet_t_minimap; // 'M'
   
   skip = 0;
@@ -530,24 +901,18 @@ void GameServer::BroadcastMinimap() {
     }
   }
   if (skip > 0) packet_rev.data.push_back(static_cast<uint8_t>(128 + skip));
+}
 
+void GameServer::CollectMinimap(UpdateSnapshot *snapshot) {
+  TraceScope trace("GameServer::CollectMinimap");
   // ---------------------------------------------------------
-  // C. Send appropriate packet to each session
+  // C. Queue the packet for each session, the sender picks the format
   // ---------------------------------------------------------
-  const long now = GetCurrentTime();
-  for (auto it = sessions.begin(); it != sessions.end(); ++it) {
-      if (it->second.snake_id == 0) continue;
-      
-      const uint16_t interval = static_cast<uint16_t>(now - it->second.last_packet_time);
-      it->second.last_packet_time = now;
-
-      if (it->second.is_modern_protocol()) {
-          packet_rev.client_time = interval;
-          endpoint.send_binary(it->first, packet_rev);
-      } else {
-          packet_fwd.client_time = interval;
-          endpoint.send_binary(it->first, packet_fwd);
-      }
+  snapshot->minimap_fwd = minimap_fwd;
+  snapshot->minimap_rev = minimap_rev;
+  for (auto &s : sessions) {
+      if (s.second.snake_id == 0) continue;
+      snapshot->AddMinimap(s.second.recipient);
   }
 }
 
@@ -555,17 +920,20 @@ void GameServer::BroadcastMinimap() {
 // UPDATED SendPOVUpdateTo (Hybrid Protocol Support)
 // ----------------------------------------------------------------------------
 void GameServer::SendPOVUpdateTo(SessionIter ses_i, Snake *ptr) {
+  TraceScope trace("GameServer::SendPOVUpdateTo");
   bool is_modern = ses_i->second.is_modern_protocol();
 
   if (!ptr->vp.new_sectors.empty()) {
+    FoodSeq food;
     for (const Sector *s_ptr : ptr->vp.new_sectors) {
       send_binary(ses_i, packet_add_sector(s_ptr->x, s_ptr->y));
+      s_ptr->food.CopyTo(&food);
       
       // HYBRID CHECK
       if (is_modern) {
-          send_binary(ses_i, packet_set_food_rel(&s_ptr->food));
+          send_binary(ses_i, packet_set_food_rel(&food));
       } else {
-          send_binary(ses_i, packet_set_food_abs(&s_ptr->food));
+          send_binary(ses_i, packet_set_food_abs(&food));
       }
     }
     ptr->vp.new_sectors.clear();
@@ -579,7 +947,27 @@ void GameServer::SendPOVUpdateTo(SessionIter ses_i, Snake *ptr) {
   }
 }
 
+void GameServer::CollectPOVUpdate(uint32_t to, Snake *ptr, UpdateSnapshot *snapshot) {
+  TraceScope trace("GameServer::CollectPOVUpdate");
+  if (!ptr->vp.new_sectors.empty()) {
+    for (const Sector *s_ptr : ptr->vp.new_sectors) {
+      snapshot->Add(to, packet_add_sector(s_ptr->x, s_ptr->y));
+      snapshot->AddSectorFood(to, s_ptr->food);
+    }
+    ptr->vp.new_sectors.clear();
+  }
+
+  if (!ptr->vp.old_sectors.empty()) {
+    for (const Sector *s_ptr : ptr->vp.old_sectors) {
+      snapshot->Add(to, packet_remove_sector(s_ptr->x, s_ptr->y));
+    }
+    ptr->vp.old_sectors.clear();
+  }
+}
+
 void GameServer::RemoveDeadSnakes() {
+  TraceScope trace("GameServer::RemoveDeadSnakes");
+  tick_deaths += static_cast<uint32_t>(world.GetDead().size());
   for (auto id : world.GetDead()) {
     RemoveSnake(id);
   }
@@ -599,6 +987,7 @@ void GameServer::on_open(connection_hdl hdl) {
 
 void GameServer::on_message(connection_hdl hdl, message_ptr ptr) {
   std::lock_guard<std::mutex> lock(game_mutex);
+  TraceScope trace("GameServer::on_message");
   if (ptr->get_opcode() != opcode::binary) {
     endpoint.get_alog().write(alevel::app,
         "Unknown incoming message opcode " + std::to_string(ptr->get_opcode()));
@@ -731,6 +1120,7 @@ void GameServer::on_message(connection_hdl hdl, message_ptr ptr) {
             new_snake_ptr->custom_skin_data = ss.custom_skin_data;
 
             world.AddSnake(new_snake_ptr);
+            tick_joins++;
             ss.snake_id = new_snake_ptr->id;
             connections[new_snake_ptr->id] = hdl;
 
@@ -882,6 +1272,7 @@ GameServer::SessionMap::iterator GameServer::LoadSessionIter(
 void GameServer::SpawnBot() {
   auto new_bot = world.CreateSnakeBot();
   world.AddSnake(new_bot);
+  tick_joins++;
 
   // Broadcast to all clients
   for (auto &s : sessions) {
@@ -15,7 +15,10 @@ RELATIVE PATH: server/game.h
 #include <iomanip>
 #include <mutex>
 
+#include "server/flight_recorder.h"
 #include "server/server.h"
+#include "server/tick_profiler.h"
+#include "server/update_snapshot.h"
 #include "game/world.h"
 #include "packet/d_all.h"
 #include "packet/p_all.h"
@@ -32,7 +35,8 @@ using websocketpp::lib::bind;
 
 struct Session {
   snake_id_t snake_id = 0;
-  long last_packet_time = 0;
+  PacketClock last_packet_time;
+  uint32_t recipient = 0;  // index in the current update snapshot
 
   long death_timestamp = 0; 
 
@@ -47,8 +51,9 @@ struct Session {
       return protocol_version >= 25; 
   }
 
-  Session() = default;
-  Session(snake_id_t id, long now) : snake_id(id), last_packet_time(now) {}
+  Session() : last_packet_time(std::make_shared<std::atomic<long>>(0)) {}
+  Session(snake_id_t id, long now)
+      : snake_id(id), last_packet_time(std::make_shared<std::atomic<long>>(now)) {}
 };
 
 class GameServer {
@@ -67,19 +72,40 @@ class GameServer {
   void on_message(connection_hdl hdl, message_ptr ptr);
   void on_close(connection_hdl hdl);
   void on_timer(error_code const &ec);
+  void on_signal(boost::system::error_code const &ec, int signo);
+  void on_http(connection_hdl hdl);
+  void on_trace_timer(error_code const &ec);
+  void WaitSignal();
 
   void SendPOVUpdateTo(SessionIter ses_i, Snake *ptr);
-  void SendFoodUpdate(Snake *ptr);
   void BroadcastDebug();
+  // Collects the tick's updates into tick_snapshot. PublishUpdates hands it
+  // to the pipeline, which sends it while the next tick runs.
   void BroadcastUpdates();
-  void BroadcastLeaderboard();
-  void BroadcastMinimap();
+  void PublishUpdates();
+  void CollectUpdates(UpdateSnapshot *snapshot);
+  void CollectPOVUpdate(uint32_t to, Snake *ptr, UpdateSnapshot *snapshot);
+  void CollectFoodUpdate(Snake *ptr, UpdateSnapshot *snapshot);
+  void SendUpdates(const UpdateSnapshot &snapshot);
+  void SendUpdate(const UpdateSnapshot &snapshot, const UpdateSnapshot::Update &u,
+                  const UpdateSnapshot::Recipient &r);
+  // Leaderboard and minimap are built from the world first and added to
+  // the snapshot after, so the builds can overlap the session cleanup.
+  void BuildLeaderboard();
+  void CollectLeaderboard(UpdateSnapshot *snapshot);
+  void BuildMinimap();
+  void CollectMinimap(UpdateSnapshot *snapshot);
   
   void CleanupDeadSessions();
   void SpawnBot();
+  void RespawnBots();
+  void GrowSpawningSnakes();
 
   long last_leaderboard_time = 0;
   long last_minimap_time = 0;
+  long last_stats_time = 0;
+  long last_profile_time = 0;
+  long last_metrics_time = 0;
 
   SessionIter LoadSessionIter(snake_id_t id);
   void DoSnake(snake_id_t id, std::function<void(Snake *)> f);
@@ -88,6 +114,14 @@ class GameServer {
   long GetCurrentTime();
   void NextTick(long last);
   void PrintWorldInfo();
+  void PrintStats();
+  void PrintProfile(bool with_total);
+  // Counts snakes, sessions, food and send queues for /metrics.
+  void PublishMetrics();
+  void RecordTick(long now, uint32_t frames);
+  void DumpFlightRecorder(const std::string &reason);
+  // Captures a trace of the next --trace_secs seconds.
+  void StartTrace();
 
  private:
   // ... (templates and private members remain the same)
@@ -105,20 +139,23 @@ class GameServer {
   template <typename T>
   void send_binary(SessionMap::iterator s, T packet) {
     const long now = GetCurrentTime();
-    const uint16_t interval = static_cast<uint16_t>(now - s->second.last_packet_time);
-    s->second.last_packet_time = now;
-    packet.client_time = interval;
+    packet.client_time = static_cast<uint16_t>(now - s->second.last_packet_time->exchange(now));
     endpoint.send_binary(s->first, packet);
   }
 
+  template <typename T>
+  void send_timed(const UpdateSnapshot::Recipient &r, T packet) {
+    const long now = GetCurrentTime();
+    packet.client_time = static_cast<uint16_t>(now - r.clock->exchange(now));
+    endpoint.send_binary(r.hdl, packet);
+  }
+
   template <typename T>
   void broadcast_binary(T packet) {
     const long now = GetCurrentTime();
     for (auto &s : sessions) {
       if (s.second.snake_id == 0) continue;
-      const uint16_t interval = static_cast<uint16_t>(now - s.second.last_packet_time);
-      s.second.last_packet_time = now;
-      packet.client_time = interval;
+      packet.client_time = static_cast<uint16_t>(now - s.second.last_packet_time->exchange(now));
       endpoint.send_binary(s.first, packet);
     }
   }
@@ -132,6 +169,7 @@ class GameServer {
 
   WSPPServer endpoint;
   WSPPServer::timer_ptr timer;
+  WSPPServer::timer_ptr trace_timer;
   long last_time_point;
   static const long timer_interval_ms = 10;
 
@@ -140,7 +178,30 @@ class GameServer {
   IncomingConfig config;
   SessionMap sessions;
   ConnectionMap connections;
+
+  JobGraph tick_graph;
+  static const size_t snake_job_grain = 64;
+
+  std::vector<std::shared_ptr<Snake>> leaderboard_snakes;  // by score
+  std::unordered_map<snake_id_t, uint16_t> leaderboard_ranks;  // players only
+  packet_leaderboard leaderboard_base;
+  static const uint16_t minimap_dim = 144;
+  packet_minimap minimap_fwd = packet_minimap(minimap_dim);
+  packet_minimap minimap_rev = packet_minimap(minimap_dim);
   
+  UpdatePipeline pipeline;
+  UpdateSnapshot *tick_snapshot = nullptr;  // from BroadcastUpdates to PublishUpdates
+
+  TickProfiler profiler;
+  ServerMetrics metrics;
+  FlightRecorder recorder;
+  FlightDumper dumper;
+  uint32_t tick_changed = 0;
+  uint32_t tick_deaths = 0;
+  uint32_t tick_joins = 0;  // since the last tick, joins come in between
+  uint64_t next_slow_dump = 0;  // recorder count
+  std::unique_ptr<boost::asio::signal_set> signals;
+
   std::mutex game_mutex;
 };
 
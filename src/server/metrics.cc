@@ -0,0 +1,175 @@
+#include "server/metrics.h"
+
+const double ServerMetrics::bucket_bounds[bucket_count] = {
+    0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25};
+
+template <typename T>
+static inline void Zero(std::atomic<T> *a, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    a[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+template <typename T>
+static inline T Load(const std::atomic<T> &a) {
+  return a.load(std::memory_order_relaxed);
+}
+
+template <typename T>
+static inline void Store(std::atomic<T> *a, T v) {
+  a->store(v, std::memory_order_relaxed);
+}
+
+ServerMetrics::ServerMetrics() {
+  for (PhaseHistogram &h : phases) {
+    Zero(h.buckets, bucket_count + 1);
+    Zero(&h.count, 1);
+    Zero(&h.sum_ns, 1);
+  }
+  Zero(&frames, 1);
+  Zero(&frames_dropped, 1);
+  Zero(packets_sent, 256);
+  Zero(bytes_sent, 256);
+  Zero(&tick_packets, 1);
+  Zero(&tick_bytes, 1);
+  Zero(&tick_largest, 1);
+  Publish(Gauges());
+}
+
+void ServerMetrics::RecordTick(const TickProfiler &profiler, uint32_t frame_count,
+                               uint32_t dropped) {
+  for (size_t p = 0; p < phase_count; p++) {
+    const tick_phase_t phase = static_cast<tick_phase_t>(p);
+    if (!profiler.get_ran(phase)) {
+      continue;
+    }
+
+    const int64_t ns = profiler.get_last(phase);
+    const double secs = ns / 1e9;
+    size_t b = 0;
+    while (b < bucket_count && secs > bucket_bounds[b]) {
+      b++;
+    }
+    PhaseHistogram &h = phases[p];
+    h.buckets[b].fetch_add(1, std::memory_order_relaxed);
+    h.count.fetch_add(1, std::memory_order_relaxed);
+    h.sum_ns.fetch_add(ns, std::memory_order_relaxed);
+  }
+
+  frames.fetch_add(frame_count, std::memory_order_relaxed);
+  frames_dropped.fetch_add(dropped, std::memory_order_relaxed);
+}
+
+void ServerMetrics::TakeTickSends(TickRecord *r) {
+  r->packets = tick_packets.exchange(0, std::memory_order_relaxed);
+  r->bytes = tick_bytes.exchange(0, std::memory_order_relaxed);
+  const uint64_t largest = tick_largest.exchange(0, std::memory_order_relaxed);
+  r->largest_packet = static_cast<uint32_t>(largest >> 8);
+  r->largest_type = static_cast<uint8_t>(largest);
+}
+
+void ServerMetrics::Publish(const Gauges &g) {
+  Store(&humans, g.humans);
+  Store(&bots, g.bots);
+  Store(&sessions_legacy, g.sessions_legacy);
+  Store(&sessions_modern, g.sessions_modern);
+  Store(&sessions_connecting, g.sessions_connecting);
+  Store(&food, g.food);
+  Store(&send_queue_bytes, g.send_queue_bytes);
+  Store(&send_queue_max_bytes, g.send_queue_max_bytes);
+  Store(&pool_in_use, g.pool_in_use);
+  Store(&pool_free, g.pool_free);
+  Store(&pool_acquired, g.pool.acquired);
+  Store(&pool_created, g.pool.created);
+  Store(&pool_reused, g.pool.reused);
+  Store(&pool_reserved, g.pool.reserved);
+  Store(&pool_released, g.pool.released);
+}
+
+static void Header(std::ostream &out, const char *name, const char *type, const char *help) {
+  out << "# HELP " << name << ' ' << help << "\n# TYPE " << name << ' ' << type << '\n';
+}
+
+template <typename T>
+static void Metric(std::ostream &out, const char *name, const char *type, const char *help,
+                   const std::atomic<T> &value) {
+  Header(out, name, type, help);
+  out << name << ' ' << Load(value) << '\n';
+}
+
+void ServerMetrics::Write(std::ostream &out) const {
+  Header(out, "slither_tick_phase_seconds", "histogram",
+         "Time spent in each phase of a server tick.");
+  for (size_t p = 0; p < phase_count; p++) {
+    const PhaseHistogram &h = phases[p];
+    const char *name = TickProfiler::get_phase_name(static_cast<tick_phase_t>(p));
+    uint64_t cumulative = 0;
+    for (size_t b = 0; b <= bucket_count; b++) {
+      cumulative += Load(h.buckets[b]);
+      out << "slither_tick_phase_seconds_bucket{phase=\"" << name << "\",le=\"";
+      if (b < bucket_count) {
+        out << bucket_bounds[b];
+      } else {
+        out << "+Inf";
+      }
+      out << "\"} " << cumulative << '\n';
+    }
+    out << "slither_tick_phase_seconds_sum{phase=\"" << name << "\"} "
+        << Load(h.sum_ns) / 1e9 << '\n';
+    out << "slither_tick_phase_seconds_count{phase=\"" << name << "\"} " << Load(h.count)
+        << '\n';
+  }
+
+  Metric(out, "slither_frames_total", "counter", "Simulated frames.", frames);
+  Metric(out, "slither_frames_dropped_total", "counter",
+         "Frames folded into a longer step because a tick ran late.", frames_dropped);
+
+  Header(out, "slither_snakes", "gauge", "Snakes in the world.");
+  out << "slither_snakes{kind=\"human\"} " << Load(humans) << '\n';
+  out << "slither_snakes{kind=\"bot\"} " << Load(bots) << '\n';
+
+  Header(out, "slither_sessions", "gauge", "Open sessions by protocol.");
+  out << "slither_sessions{protocol=\"legacy\"} " << Load(sessions_legacy) << '\n';
+  out << "slither_sessions{protocol=\"modern\"} " << Load(sessions_modern) << '\n';
+  out << "slither_sessions{protocol=\"connecting\"} " << Load(sessions_connecting) << '\n';
+
+  Metric(out, "slither_food", "gauge", "Food pellets in the world.", food);
+
+  Header(out, "slither_packets_sent_total", "counter", "Packets queued for sending by type.");
+  for (size_t t = 0; t < 256; t++) {
+    const uint64_t n = Load(packets_sent[t]);
+    if (n > 0) {
+      out << "slither_packets_sent_total{type=\"" << static_cast<char>(t) << "\"} " << n
+          << '\n';
+    }
+  }
+  Header(out, "slither_bytes_sent_total", "counter",
+         "Packet bytes queued for sending by type, without websocket framing.");
+  for (size_t t = 0; t < 256; t++) {
+    const uint64_t n = Load(bytes_sent[t]);
+    if (n > 0) {
+      out << "slither_bytes_sent_total{type=\"" << static_cast<char>(t) << "\"} " << n
+          << '\n';
+    }
+  }
+
+  Metric(out, "slither_send_queue_bytes", "gauge",
+         "Bytes waiting in the send queues of all connections.", send_queue_bytes);
+  Metric(out, "slither_send_queue_max_bytes", "gauge",
+         "Bytes waiting in the longest send queue.", send_queue_max_bytes);
+
+  Metric(out, "slither_snake_pool_in_use", "gauge", "Pooled snakes in the world.",
+         pool_in_use);
+  Metric(out, "slither_snake_pool_free", "gauge", "Pooled snakes on the free list.",
+         pool_free);
+  Metric(out, "slither_snake_pool_acquired_total", "counter", "Snakes taken from the pool.",
+         pool_acquired);
+  Metric(out, "slither_snake_pool_created_total", "counter",
+         "Snakes allocated because the free list was empty.", pool_created);
+  Metric(out, "slither_snake_pool_reused_total", "counter",
+         "Released snakes taken from the free list.", pool_reused);
+  Metric(out, "slither_snake_pool_reserved_total", "counter",
+         "Snakes preallocated at startup handed out for the first time.", pool_reserved);
+  Metric(out, "slither_snake_pool_released_total", "counter", "Snakes returned to the pool.",
+         pool_released);
+}
@@ -0,0 +1,91 @@
+#ifndef SRC_SERVER_METRICS_H_
+#define SRC_SERVER_METRICS_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "game/snake_pool.h"
+#include "server/flight_recorder.h"
+#include "server/tick_profiler.h"
+
+// Server metrics in the Prometheus text format, served on /metrics.
+//
+// Everything is an atomic written with relaxed stores: sends count from any
+// thread, the game loop records its tick and publishes the gauges once a
+// second, and a scrape reads them without the game lock. A scrape may see
+// a tick half recorded, which Prometheus tolerates.
+class ServerMetrics {
+ public:
+  struct Gauges {
+    uint32_t humans = 0;
+    uint32_t bots = 0;
+    uint32_t sessions_legacy = 0;
+    uint32_t sessions_modern = 0;
+    uint32_t sessions_connecting = 0;  // no snake yet
+    uint64_t food = 0;
+    uint64_t send_queue_bytes = 0;
+    uint64_t send_queue_max_bytes = 0;  // largest single connection
+    uint64_t pool_in_use = 0;
+    uint64_t pool_free = 0;
+    SnakePool::Stats pool;
+  };
+
+  ServerMetrics();
+  ServerMetrics(const ServerMetrics &) = delete;
+  ServerMetrics &operator=(const ServerMetrics &) = delete;
+
+  // A packet of this type went to the send queue of a connection.
+  void CountSend(uint8_t packet_type, size_t bytes) {
+    packets_sent[packet_type].fetch_add(1, std::memory_order_relaxed);
+    bytes_sent[packet_type].fetch_add(bytes, std::memory_order_relaxed);
+    tick_packets.fetch_add(1, std::memory_order_relaxed);
+    tick_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    const uint64_t largest = bytes << 8 | packet_type;
+    uint64_t seen = tick_largest.load(std::memory_order_relaxed);
+    while (largest > seen &&
+           !tick_largest.compare_exchange_weak(seen, largest, std::memory_order_relaxed)) {
+    }
+  }
+
+  // What was sent since the last call, for the flight recorder.
+  void TakeTickSends(TickRecord *r);
+
+  // The phases of the last tick, how many frames it simulated and how many
+  // of those were over what a tick on time simulates.
+  void RecordTick(const TickProfiler &profiler, uint32_t frames, uint32_t dropped);
+  void Publish(const Gauges &g);
+
+  void Write(std::ostream &out) const;
+
+  // Upper bounds of the tick histogram buckets, in seconds.
+  static const size_t bucket_count = 11;
+  static const double bucket_bounds[bucket_count];
+
+ private:
+  struct PhaseHistogram {
+    std::atomic<uint64_t> buckets[bucket_count + 1];  // the last is +Inf
+    std::atomic<uint64_t> count;
+    std::atomic<int64_t> sum_ns;
+  };
+
+  PhaseHistogram phases[phase_count];
+  std::atomic<uint64_t> frames;
+  std::atomic<uint64_t> frames_dropped;
+
+  std::atomic<uint64_t> packets_sent[256];
+  std::atomic<uint64_t> bytes_sent[256];
+  std::atomic<uint64_t> tick_packets, tick_bytes;
+  std::atomic<uint64_t> tick_largest;  // size << 8 | type
+
+  std::atomic<uint32_t> humans, bots;
+  std::atomic<uint32_t> sessions_legacy, sessions_modern, sessions_connecting;
+  std::atomic<uint64_t> food;
+  std::atomic<uint64_t> send_queue_bytes, send_queue_max_bytes;
+  std::atomic<uint64_t> pool_in_use, pool_free;
+  std::atomic<uint64_t> pool_acquired, pool_created, pool_reused, pool_reserved;
+  std::atomic<uint64_t> pool_released;
+};
+
+#endif  // SRC_SERVER_METRICS_H_
@@ -12,6 +12,7 @@ RELATIVE PATH: server/server.h
 #include <websocketpp/server.hpp>
 
 #include "server/config.h"
+#include "server/metrics.h"
 // #include "server/streambuf_array.h" // DISABLED: Causing Stack Overflows
 
 typedef websocketpp::connection_hdl connection_hdl;
@@ -41,6 +42,11 @@ class WSPPServer : public websocketpp::server<WSPPServerConfig> {
 
     // Send the exact amount of data written
     ec = con->send(boost::asio::buffer_cast<void const *>(buf.data()), buf.size(), op);
+    if (!ec && metrics != nullptr && buf.size() > 2) {
+      // the type on the wire, rotations pick theirs while encoding
+      const uint8_t *data = boost::asio::buffer_cast<const uint8_t *>(buf.data());
+      metrics->CountSend(data[2], buf.size());
+    }
   }
 
   template <typename T>
@@ -56,6 +62,12 @@ class WSPPServer : public websocketpp::server<WSPPServerConfig> {
       std::cerr << "[NET ERROR] Send failed: " << ec.message() << std::endl;
     }
   }
+
+  // Counts the packets sent, if set.
+  void set_metrics(ServerMetrics *m) { metrics = m; }
+
+ private:
+  ServerMetrics *metrics = nullptr;
 };
 
 typedef WSPPServer::message_ptr message_ptr;
@@ -0,0 +1,140 @@
+#include "server/tick_profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+
+size_t LatencyHistogram::BucketOf(int64_t ns) {
+  if (ns < static_cast<int64_t>(sub_count)) {
+    return ns > 0 ? static_cast<size_t>(ns) : 0;
+  }
+  const uint64_t v = static_cast<uint64_t>(ns);
+  const size_t msb = 63 - static_cast<size_t>(__builtin_clzll(v));
+  const size_t shift = msb - sub_bits;
+  const size_t bucket = (shift + 1) * sub_count + ((v >> shift) - sub_count);
+  return std::min(bucket, bucket_count - 1);
+}
+
+int64_t LatencyHistogram::BucketMax(size_t bucket) {
+  if (bucket < sub_count) {
+    return static_cast<int64_t>(bucket);
+  }
+  const size_t shift = bucket / sub_count - 1;
+  const uint64_t mantissa = sub_count + bucket % sub_count;
+  return static_cast<int64_t>(((mantissa + 1) << shift) - 1);
+}
+
+void LatencyHistogram::Record(int64_t ns) {
+  counts[BucketOf(ns)]++;
+  count++;
+  sum += ns;
+  max = std::max(max, ns);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram &h) {
+  for (size_t i = 0; i < bucket_count; i++) {
+    counts[i] += h.counts[i];
+  }
+  count += h.count;
+  sum += h.sum;
+  max = std::max(max, h.max);
+}
+
+void LatencyHistogram::Clear() {
+  std::fill(counts, counts + bucket_count, 0);
+  count = 0;
+  sum = 0;
+  max = 0;
+}
+
+int64_t LatencyHistogram::Percentile(double p) const {
+  if (count == 0) {
+    return 0;
+  }
+  const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(p * count + 0.5));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < bucket_count; i++) {
+    seen += counts[i];
+    if (seen >= rank) {
+      return std::min(BucketMax(i), max);
+    }
+  }
+  return max;
+}
+
+TickProfiler::Scope::~Scope() {
+  profiler->Add(phase, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - start).count());
+}
+
+void TickProfiler::BeginTick() {
+  std::fill(current, current + phase_count, 0);
+  std::fill(ran, ran + phase_count, false);
+}
+
+void TickProfiler::Add(tick_phase_t phase, int64_t ns) {
+  current[phase] += ns;
+  ran[phase] = true;
+}
+
+void TickProfiler::AddWorldPhases(const TickPhases &phases) {
+  Add(phase_ai, phases.bot_ai);
+  Add(phase_move, phases.move);
+  Add(phase_commit, phases.commit);
+  Add(phase_collision, phases.collision);
+  Add(phase_food, phases.food);
+}
+
+void TickProfiler::EndTick() {
+  for (size_t p = 0; p < phase_count; p++) {
+    last[p] = ran[p] ? current[p] : 0;
+    if (ran[p]) {
+      window[p].Record(current[p]);
+      total[p].Record(current[p]);
+    }
+  }
+}
+
+void TickProfiler::ResetWindow() {
+  for (LatencyHistogram &h : window) {
+    h.Clear();
+  }
+}
+
+const char *TickProfiler::get_phase_name(tick_phase_t phase) {
+  static const char *const names[phase_count] = {
+      "tick",  "world", "ai",        "move",        "commit",  "collision",
+      "food",  "spawn", "broadcast", "leaderboard", "minimap", "cleanup"};
+  return names[phase];
+}
+
+void TickProfiler::Print(std::ostream &out, const LatencyHistogram *h) {
+  char line[128];
+  snprintf(line, sizeof(line), "%-12s %8s %8s %8s %8s %8s %8s", "phase (ms)", "count",
+           "mean", "p50", "p90", "p99", "max");
+  out << line;
+  for (size_t p = 0; p < phase_count; p++) {
+    snprintf(line, sizeof(line), "\n%-12s %8llu %8.3f %8.3f %8.3f %8.3f %8.3f",
+             get_phase_name(static_cast<tick_phase_t>(p)),
+             static_cast<unsigned long long>(h[p].get_count()), h[p].get_mean() / 1e6,
+             h[p].Percentile(0.5) / 1e6, h[p].Percentile(0.9) / 1e6,
+             h[p].Percentile(0.99) / 1e6, h[p].get_max() / 1e6);
+    out << line;
+  }
+}
+
+void TickProfiler::PrintWindow(std::ostream &out) const { Print(out, window); }
+
+void TickProfiler::PrintTotal(std::ostream &out) const { Print(out, total); }
+
+void TickProfiler::PrintLast(std::ostream &out) const {
+  char part[48];
+  const char *sep = "";
+  for (size_t p = phase_world; p < phase_count; p++) {
+    if (last[p] > 0) {
+      snprintf(part, sizeof(part), "%s%s %.3f", sep,
+               get_phase_name(static_cast<tick_phase_t>(p)), last[p] / 1e6);
+      out << part;
+      sep = ", ";
+    }
+  }
+}
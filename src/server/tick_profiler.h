@@ -0,0 +1,114 @@
+#ifndef SRC_SERVER_TICK_PROFILER_H_
+#define SRC_SERVER_TICK_PROFILER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "game/world.h"
+
+// Phases of a server tick. phase_ai to phase_food split phase_world, they
+// come from World::GetTickPhases and are only recorded on ticks that
+// simulated a frame.
+enum tick_phase_t : uint8_t {
+  phase_tick = 0,  // the whole tick
+  phase_world,
+  phase_ai,
+  phase_move,
+  phase_commit,
+  phase_collision,
+  phase_food,
+  phase_spawn,  // bot respawn and spawn growth
+  phase_broadcast,
+  phase_leaderboard,
+  phase_minimap,
+  phase_cleanup,  // dead snakes and sessions
+  phase_count
+};
+
+// Latency histogram with log-linear buckets, in the spirit of HDR
+// histograms: exact below 16 ns, then 16 buckets per power of two, so any
+// value is off by at most 1/16 (6%). The last bucket starts at
+// 2^41 - 2^36 ns, about 35 minutes, and takes every larger value.
+// Recording is a bit scan and an increment.
+class LatencyHistogram {
+ public:
+  LatencyHistogram() { Clear(); }
+
+  void Record(int64_t ns);
+  void Merge(const LatencyHistogram &h);
+  void Clear();
+
+  uint64_t get_count() const { return count; }
+  int64_t get_max() const { return max; }
+  double get_mean() const { return count > 0 ? static_cast<double>(sum) / count : 0.0; }
+  // Upper bound of the bucket holding the p-th value, p in [0, 1].
+  int64_t Percentile(double p) const;
+
+  static const size_t sub_bits = 4;
+  static const size_t sub_count = 1 << sub_bits;
+  static const size_t bucket_count = sub_count * 38;
+
+ private:
+  static size_t BucketOf(int64_t ns);
+  static int64_t BucketMax(size_t bucket);
+
+  uint32_t counts[bucket_count];
+  uint64_t count;
+  int64_t sum;
+  int64_t max;
+};
+
+// Times the phases of every server tick into one histogram per phase: one
+// for the current window, reset by ResetWindow, and one since the start.
+// Phases of one tick may be timed on different job threads, each phase by
+// one job at a time; EndTick runs after the jobs are joined.
+class TickProfiler {
+ public:
+  // Adds the time until destruction to a phase of the current tick.
+  class Scope {
+   public:
+    Scope(TickProfiler *in_profiler, tick_phase_t in_phase)
+        : profiler(in_profiler), phase(in_phase), start(std::chrono::steady_clock::now()) {}
+    ~Scope();
+
+   private:
+    TickProfiler *profiler;
+    tick_phase_t phase;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  void BeginTick();
+  void Add(tick_phase_t phase, int64_t ns);
+  // Splits the world phase, for ticks that simulated a frame.
+  void AddWorldPhases(const TickPhases &phases);
+  // Records the phases that ran into the histograms.
+  void EndTick();
+
+  // Time of a phase in the last tick, 0 if it did not run.
+  int64_t get_last(tick_phase_t phase) const { return last[phase]; }
+  bool get_ran(tick_phase_t phase) const { return ran[phase]; }
+  const LatencyHistogram &get_window(tick_phase_t phase) const { return window[phase]; }
+  const LatencyHistogram &get_total(tick_phase_t phase) const { return total[phase]; }
+  void ResetWindow();
+
+  // One line per phase: count, mean, p50, p90, p99 and max in ms.
+  void PrintWindow(std::ostream &out) const;
+  void PrintTotal(std::ostream &out) const;
+  // The phases of the last tick, "world 8.120 ms, ..."
+  void PrintLast(std::ostream &out) const;
+
+  static const char *get_phase_name(tick_phase_t phase);
+
+ private:
+  static void Print(std::ostream &out, const LatencyHistogram *h);
+
+  int64_t current[phase_count] = {};
+  bool ran[phase_count] = {};
+  int64_t last[phase_count] = {};
+  LatencyHistogram window[phase_count];
+  LatencyHistogram total[phase_count];
+};
+
+#endif  // SRC_SERVER_TICK_PROFILER_H_
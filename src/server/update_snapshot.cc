@@ -0,0 +1,167 @@
+#include "server/update_snapshot.h"
+
+#include "game/trace.h"
+
+void UpdateSnapshot::Clear() {
+  recipients.clear();
+  updates.clear();
+  rotations.clear();
+  incs.clear();
+  moves.clear();
+  remove_parts.clear();
+  fullness.clear();
+  remove_snakes.clear();
+  ends.clear();
+  add_sectors.clear();
+  remove_sectors.clear();
+  sector_food_count = 0;
+  eaten.clear();
+  spawned.clear();
+  leaderboard.top.clear();
+  leaderboard_ranks.clear();
+  minimap_fwd.data.clear();
+  minimap_rev.data.clear();
+}
+
+void UpdateSnapshot::Add(uint32_t to, const packet_rotation &p) {
+  Push(update_rotation, to, &rotations, p);
+}
+
+void UpdateSnapshot::Add(uint32_t to, const packet_inc &p) {
+  Push(update_inc, to, &incs, p);
+}
+
+void UpdateSnapshot::Add(uint32_t to, const packet_move &p) {
+  Push(update_move, to, &moves, p);
+}
+
+void UpdateSnapshot::Add(uint32_t to, const packet_remove_part &p) {
+  Push(update_remove_part, to, &remove_parts, p);
+}
+
+void UpdateSnapshot::Add(uint32_t to, const packet_fullness &p) {
+  Push(update_fullness, to, &fullness, p);
+}
+
+void UpdateSnapshot::Add(uint32_t to, const packet_remove_snake &p) {
+  Push(update_remove_snake, to, &remove_snakes, p);
+}
+
+void UpdateSnapshot::Add(uint32_t to, const packet_end &p) {
+  Push(update_end, to, &ends, p);
+}
+
+void UpdateSnapshot::Add(uint32_t to, const packet_add_sector &p) {
+  Push(update_add_sector, to, &add_sectors, p);
+}
+
+void UpdateSnapshot::Add(uint32_t to, const packet_remove_sector &p) {
+  Push(update_remove_sector, to, &remove_sectors, p);
+}
+
+void UpdateSnapshot::AddSectorFood(uint32_t to, const FoodStore &food) {
+  if (sector_food_count == sector_food.size()) {
+    sector_food.emplace_back();
+  }
+  food.CopyTo(&sector_food[sector_food_count]);
+  updates.push_back(Update{update_set_food, to, static_cast<uint32_t>(sector_food_count)});
+  sector_food_count++;
+}
+
+void UpdateSnapshot::AddEatenFood(snake_id_t snake_id, Food food) {
+  Push(update_eat_food, to_all, &eaten, EatenFood{snake_id, food});
+}
+
+void UpdateSnapshot::AddSpawnedFood(Food food) {
+  Push(update_spawn_food, to_all, &spawned, food);
+}
+
+void UpdateSnapshot::AddLeaderboard(uint32_t to, uint16_t local_rank) {
+  Push(update_leaderboard, to, &leaderboard_ranks, local_rank);
+}
+
+void UpdateSnapshot::AddMinimap(uint32_t to) {
+  updates.push_back(Update{update_minimap, to, 0});
+}
+
+UpdatePipeline::UpdatePipeline() {
+  for (UpdateSnapshot &slot : slots) {
+    free_slots.push_back(&slot);
+  }
+}
+
+UpdatePipeline::~UpdatePipeline() { Stop(); }
+
+void UpdatePipeline::Start(SendFn fn) {
+  Stop();
+
+  send = fn;
+  stopping = false;
+  sender = std::thread(&UpdatePipeline::SenderLoop, this);
+}
+
+void UpdatePipeline::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  changed.notify_all();
+
+  if (sender.joinable()) {
+    sender.join();
+  }
+}
+
+UpdateSnapshot *UpdatePipeline::Acquire() {
+  std::unique_lock<std::mutex> lock(mutex);
+  changed.wait(lock, [this] { return !free_slots.empty(); });
+  UpdateSnapshot *snapshot = free_slots.back();
+  free_slots.pop_back();
+  return snapshot;
+}
+
+void UpdatePipeline::Publish(UpdateSnapshot *snapshot) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (sender.joinable()) {
+      ready.push_back(snapshot);
+      snapshot = nullptr;
+    }
+  }
+  changed.notify_all();
+
+  // no sender running, send on the caller
+  if (snapshot != nullptr) {
+    if (send) {
+      send(*snapshot);
+    }
+    snapshot->Clear();
+    std::lock_guard<std::mutex> lock(mutex);
+    free_slots.push_back(snapshot);
+  }
+}
+
+void UpdatePipeline::SenderLoop() {
+  Tracer::SetThreadName("update sender");
+  for (;;) {
+    UpdateSnapshot *snapshot = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      changed.wait(lock, [this] { return stopping || !ready.empty(); });
+      if (ready.empty()) {
+        return;
+      }
+      snapshot = ready.front();
+      ready.pop_front();
+    }
+
+    send(*snapshot);
+    snapshot->Clear();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      free_slots.push_back(snapshot);
+    }
+    changed.notify_all();
+  }
+}
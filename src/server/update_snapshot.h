@@ -0,0 +1,152 @@
+#ifndef SRC_SERVER_UPDATE_SNAPSHOT_H_
+#define SRC_SERVER_UPDATE_SNAPSHOT_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "game/food.h"
+#include "game/food_store.h"
+#include "packet/p_all.h"
+#include "server/server.h"
+
+// Time of the last packet sent to a session. Shared with the update sender,
+// which may still hold it after the session is gone.
+typedef std::shared_ptr<std::atomic<long>> PacketClock;
+
+enum update_kind_t : uint8_t {
+  update_rotation,
+  update_inc,
+  update_move,
+  update_remove_part,
+  update_fullness,
+  update_remove_snake,
+  update_end,
+  update_add_sector,
+  update_remove_sector,
+  update_set_food,
+  update_eat_food,
+  update_spawn_food,
+  update_leaderboard,
+  update_minimap,
+};
+
+// Everything the per tick updates send, captured as plain data under the
+// game lock, so it can be encoded and sent while the next tick runs.
+// Clear() keeps the capacity of every list for the next tick.
+struct UpdateSnapshot {
+  struct Recipient {
+    connection_hdl hdl;
+    PacketClock clock;
+    snake_id_t snake_id;
+    uint8_t protocol_version;
+    bool is_modern;
+  };
+
+  struct Update {
+    update_kind_t kind;
+    uint32_t to;     // index in recipients, or to_all
+    uint32_t index;  // in the list of its kind
+  };
+
+  struct EatenFood {
+    snake_id_t snake_id;
+    Food food;
+  };
+
+  // sessions with a snake
+  static const uint32_t to_all = UINT32_MAX;
+
+  std::vector<Recipient> recipients;
+  std::vector<Update> updates;
+
+  std::vector<packet_rotation> rotations;
+  std::vector<packet_inc> incs;
+  std::vector<packet_move> moves;
+  std::vector<packet_remove_part> remove_parts;
+  std::vector<packet_fullness> fullness;
+  std::vector<packet_remove_snake> remove_snakes;
+  std::vector<packet_end> ends;
+  std::vector<packet_add_sector> add_sectors;
+  std::vector<packet_remove_sector> remove_sectors;
+  std::vector<std::vector<Food>> sector_food;  // first sector_food_count used
+  size_t sector_food_count = 0;
+  std::vector<EatenFood> eaten;
+  std::vector<Food> spawned;
+  // sent with the local rank of each recipient
+  packet_leaderboard leaderboard;
+  std::vector<uint16_t> leaderboard_ranks;
+  // reverse packet for modern clients, forward for legacy ones
+  packet_minimap minimap_fwd = packet_minimap(0);
+  packet_minimap minimap_rev = packet_minimap(0);
+
+  void Clear();
+
+  void Add(uint32_t to, const packet_rotation &p);
+  void Add(uint32_t to, const packet_inc &p);
+  void Add(uint32_t to, const packet_move &p);
+  void Add(uint32_t to, const packet_remove_part &p);
+  void Add(uint32_t to, const packet_fullness &p);
+  void Add(uint32_t to, const packet_remove_snake &p);
+  void Add(uint32_t to, const packet_end &p);
+  void Add(uint32_t to, const packet_add_sector &p);
+  void Add(uint32_t to, const packet_remove_sector &p);
+  // copies the food, encoded relative or absolute per recipient
+  void AddSectorFood(uint32_t to, const FoodStore &food);
+  void AddEatenFood(snake_id_t snake_id, Food food);
+  void AddSpawnedFood(Food food);
+  // leaderboard and minimap are set by the caller first
+  void AddLeaderboard(uint32_t to, uint16_t local_rank);
+  void AddMinimap(uint32_t to);
+
+ private:
+  template <typename T>
+  void Push(update_kind_t kind, uint32_t to, std::vector<T> *list, const T &item) {
+    updates.push_back(Update{kind, to, static_cast<uint32_t>(list->size())});
+    list->push_back(item);
+  }
+};
+
+// Hands snapshots from the game loop to a sender thread. Three snapshots
+// rotate between being filled, waiting and being sent, so the game loop only
+// waits when the sender falls two ticks behind.
+class UpdatePipeline {
+ public:
+  typedef std::function<void(const UpdateSnapshot &)> SendFn;
+
+  UpdatePipeline();
+  UpdatePipeline(const UpdatePipeline &) = delete;
+  UpdatePipeline &operator=(const UpdatePipeline &) = delete;
+  ~UpdatePipeline();
+
+  void Start(SendFn fn);
+  // Sends the published snapshots and stops the sender.
+  void Stop();
+
+  // A cleared snapshot to fill, hand it back with Publish.
+  UpdateSnapshot *Acquire();
+  void Publish(UpdateSnapshot *snapshot);
+
+  static const size_t slot_count = 3;
+
+ private:
+  void SenderLoop();
+
+  UpdateSnapshot slots[slot_count];
+  std::vector<UpdateSnapshot *> free_slots;
+  std::deque<UpdateSnapshot *> ready;
+
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::thread sender;
+  bool stopping = false;
+  SendFn send;
+};
+
+#endif  // SRC_SERVER_UPDATE_SNAPSHOT_H_
@@ -0,0 +1,103 @@
+// Check of the bot AI schedule at the server's tick cadence.
+//
+// Runs HeadlessSim without determinism, so every tick advances the world
+// by --dt ms (the server ticks every 10 ms and simulates one or two 8 ms
+// frames). After each tick no live bot may still wait past the AI interval
+// of its detail tier: a due bot must be served by the tick it became due
+// in. Exits with 1 when one did.
+//
+//   ./bin/bot_ai_check [--ticks N] [--bots N] [--humans N] [--dt MS]
+//                      [--threads T]
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "game/headless_sim.h"
+
+namespace {
+
+struct Options {
+  uint32_t ticks = 3000;
+  uint16_t bots = 1000;
+  uint16_t humans = 8;
+  long dt = 2 * WorldConfig::frame_time_ms;
+  uint16_t threads = 1;
+};
+
+void Usage(FILE *out) {
+  fprintf(out,
+          "usage: bot_ai_check [--ticks N] [--bots N] [--humans N] [--dt MS]\n"
+          "                    [--threads T]\n");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options o;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h") {
+      Usage(stdout);
+      return 0;
+    }
+    if (i + 1 >= argc) {
+      fprintf(stderr, "missing value for %s\n", arg.c_str());
+      Usage(stderr);
+      return 2;
+    }
+    const char *value = argv[++i];
+    if (arg == "--ticks") {
+      o.ticks = static_cast<uint32_t>(atol(value));
+    } else if (arg == "--bots") {
+      o.bots = static_cast<uint16_t>(atoi(value));
+    } else if (arg == "--humans") {
+      o.humans = static_cast<uint16_t>(atoi(value));
+    } else if (arg == "--dt") {
+      o.dt = atol(value);
+    } else if (arg == "--threads") {
+      o.threads = static_cast<uint16_t>(atoi(value));
+    } else {
+      fprintf(stderr, "unknown option %s\n", arg.c_str());
+      Usage(stderr);
+      return 2;
+    }
+  }
+  if (o.dt < WorldConfig::frame_time_ms) {
+    fprintf(stderr, "--dt must be at least a frame, %ld ms\n",
+            static_cast<long>(WorldConfig::frame_time_ms));
+    return 2;
+  }
+
+  WorldConfig config;
+  config.bots = o.bots;
+  config.sim_threads = o.threads;
+  config.random_seed = 1;
+  HeadlessSim sim(config, o.humans);
+
+  uint64_t overdue = 0;
+  long worst = 0;  // ms past the interval
+  for (uint32_t t = 0; t < o.ticks; t++) {
+    sim.Step(o.dt);
+    for (const Snake *s : sim.get_world().GetTickOrder()) {
+      if (!s->bot || (s->update & (change_dying | change_dead))) continue;
+
+      const long late = s->get_ai_ticks() - Snake::get_ai_interval(s->lod);
+      if (late > 0) {
+        if (overdue == 0) {
+          printf("bot %u waits %ld ms past its interval after tick %u\n", s->id, late, t);
+        }
+        overdue++;
+        worst = late > worst ? late : worst;
+      }
+    }
+  }
+
+  const BotScheduler::Stats &st = sim.get_world().GetBotScheduler().get_stats();
+  printf("%u ticks of %ld ms, %llu decisions, %llu deferred, %llu overdue bot ticks, "
+         "worst %ld ms late\n",
+         o.ticks, o.dt, static_cast<unsigned long long>(st.decisions),
+         static_cast<unsigned long long>(st.deferred), static_cast<unsigned long long>(overdue),
+         worst);
+  return overdue > 0 ? 1 : 0;
+}
@@ -0,0 +1,476 @@
+// WebSocket load generator for slither_server.
+//
+// Opens N client connections and plays them like browsers would. Each
+// connection logs in with 'c', waits for the pre-init '6' and sends 's', as
+// a legacy (JS) or modern (C) client. It then steers with random-walk angle
+// bytes, boosts now and then and pings every 250 ms. A killed player is
+// kicked by the server and reconnects a second later.
+//
+// Every 5 s it prints a progress line. At the end it reports the connect
+// rate and time, the bytes and packets received by packet type, and the
+// ping to pong round trip percentiles. The round trip is the delay a
+// client sees on any server packet, including the send queue behind the
+// world updates.
+//
+//   ./bin/load_gen [--host H] [--port P] [--players N] [--secs S]
+//                  [--rate R] [--protocol legacy|modern|mixed] [--seed S]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <websocketpp/client.hpp>
+#include <websocketpp/config/asio_no_tls_client.hpp>
+
+#include "game/random.h"
+#include "packet/p_base.h"
+
+namespace {
+
+typedef websocketpp::client<websocketpp::config::asio_client> WSClient;
+typedef websocketpp::connection_hdl connection_hdl;
+using websocketpp::lib::bind;
+using websocketpp::lib::placeholders::_1;
+using websocketpp::lib::placeholders::_2;
+
+struct Options {
+  std::string host = "localhost";
+  uint16_t port = 8080;
+  size_t players = 500;
+  uint32_t secs = 60;
+  uint32_t rate = 100;  // new connections per second
+  std::string protocol = "mixed";
+  uint64_t seed = 1;
+};
+
+enum stage_t : uint8_t {
+  stage_idle,
+  stage_connecting,
+  stage_login,    // open, waiting for '6'
+  stage_joining,  // 's' sent, waiting for the init packet
+  stage_playing,
+  stage_dead,     // 'v' received, waiting to be kicked
+};
+
+struct Player {
+  connection_hdl hdl;
+  stage_t stage = stage_idle;
+  bool modern = false;
+  bool boost = false;
+  uint8_t angle = 0;
+  int64_t retry_ns = 0;    // idle until then
+  int64_t connect_ns = 0;  // connect started
+  int64_t ping_ns = 0;     // ping in flight since, 0 if none
+  int64_t next_ping_ns = 0;
+};
+
+int64_t NowNs() {
+  using std::chrono::duration_cast;
+  using std::chrono::nanoseconds;
+  using std::chrono::steady_clock;
+  return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+double Percentile(std::vector<int64_t> *v, double p) {
+  if (v->empty()) {
+    return 0.0;
+  }
+  const size_t k = std::min(v->size() - 1, static_cast<size_t>(p * v->size()));
+  std::nth_element(v->begin(), v->begin() + k, v->end());
+  return (*v)[k] / 1e6;
+}
+
+class LoadGen {
+ public:
+  explicit LoadGen(const Options &o);
+  void Run();
+  void PrintReport();
+
+ private:
+  void Connect(size_t i);
+  void Send(size_t i, const std::string &data);
+  void SendLogin(size_t i);
+  void Steer(size_t i);
+
+  void OnTimer(const websocketpp::lib::error_code &ec);
+  void OnOpen(size_t i, connection_hdl hdl);
+  void OnFail(size_t i, connection_hdl hdl);
+  void OnClose(size_t i, connection_hdl hdl);
+  void OnMessage(size_t i, connection_hdl hdl, WSClient::message_ptr msg);
+  void Disconnected(size_t i);
+  void PrintProgress(int64_t now);
+
+  Options options;
+  WSClient client;
+  Random rng;
+  std::vector<Player> players;
+  bool running = true;
+  int64_t start_ns = 0;
+  int64_t last_progress_ns = 0;
+  size_t open = 0;
+  size_t playing = 0;
+
+  // all players open for the first time
+  int64_t all_open_ns = 0;
+  uint64_t connects = 0;
+  uint64_t opened = 0;
+  uint64_t failed = 0;
+  std::map<std::string, uint64_t> fail_reasons;
+  uint64_t logins = 0;
+  uint64_t deaths = 0;
+  uint64_t rx_bytes = 0;
+  uint64_t rx_packets = 0;
+  uint64_t last_rx_bytes = 0;
+  uint64_t last_rx_packets = 0;
+  uint64_t tx_packets = 0;
+  uint64_t type_count[256] = {};
+  uint64_t type_bytes[256] = {};
+  std::vector<int64_t> connect_times;
+  std::vector<int64_t> ping_times;
+
+  static const int64_t tick_ms = 100;
+  static const int64_t ping_interval_ns = 250000000;
+  static const int64_t retry_ns = 1000000000;
+  static const int64_t progress_ns = 5000000000;
+  // protocol versions sent in 's', modern is 25 and up
+  static const uint8_t legacy_version = 10;
+  static const uint8_t modern_version = 31;
+};
+
+LoadGen::LoadGen(const Options &o) : options(o), players(o.players) {
+  client.clear_access_channels(websocketpp::log::alevel::all);
+  client.clear_error_channels(websocketpp::log::elevel::all);
+  client.init_asio();
+
+  rng.Seed(o.seed, 0);
+  for (size_t i = 0; i < players.size(); i++) {
+    players[i].modern = o.protocol == "modern" || (o.protocol == "mixed" && i % 2 == 1);
+    players[i].angle = static_cast<uint8_t>(rng.Next(251));
+  }
+}
+
+void LoadGen::Run() {
+  start_ns = NowNs();
+  last_progress_ns = start_ns;
+  client.set_timer(tick_ms, bind(&LoadGen::OnTimer, this, _1));
+  client.run();
+}
+
+void LoadGen::Connect(size_t i) {
+  Player &p = players[i];
+  const std::string uri =
+      "ws://" + options.host + ":" + std::to_string(options.port) + "/slither";
+  websocketpp::lib::error_code ec;
+  WSClient::connection_ptr con = client.get_connection(uri, ec);
+  if (ec) {
+    fprintf(stderr, "bad uri %s: %s\n", uri.c_str(), ec.message().c_str());
+    running = false;
+    client.stop();
+    return;
+  }
+
+  con->set_open_handler(bind(&LoadGen::OnOpen, this, i, _1));
+  con->set_fail_handler(bind(&LoadGen::OnFail, this, i, _1));
+  con->set_close_handler(bind(&LoadGen::OnClose, this, i, _1));
+  con->set_message_handler(bind(&LoadGen::OnMessage, this, i, _1, _2));
+  p.hdl = con->get_handle();
+  p.stage = stage_connecting;
+  p.connect_ns = NowNs();
+  p.ping_ns = 0;
+  p.next_ping_ns = 0;
+  p.boost = false;
+  connects++;
+  client.connect(con);
+}
+
+void LoadGen::Send(size_t i, const std::string &data) {
+  websocketpp::lib::error_code ec;
+  client.send(players[i].hdl, data, websocketpp::frame::opcode::binary, ec);
+  tx_packets += !ec;
+}
+
+// 's': protocol version, (modern: two bytes the server skips), skin, name,
+// (modern: 0, 255 after the name).
+void LoadGen::SendLogin(size_t i) {
+  const Player &p = players[i];
+  const std::string name = "load " + std::to_string(i);
+  std::string s(1, static_cast<char>(in_packet_t_username_skin));
+  s += static_cast<char>(p.modern ? modern_version : legacy_version);
+  if (p.modern) {
+    s += std::string(2, '\0');
+  }
+  s += static_cast<char>(i % 40);
+  s += static_cast<char>(name.size());
+  s += name;
+  if (p.modern) {
+    s += '\0';
+    s += static_cast<char>(255);
+  }
+  Send(i, s);
+  players[i].stage = stage_joining;
+}
+
+// A step of up to 10 either way on the 251 angle steps; boost starts in 2%
+// of the steps and lasts about five.
+void LoadGen::Steer(size_t i) {
+  Player &p = players[i];
+  p.angle = static_cast<uint8_t>((p.angle + 251 + rng.Next(21) - 10) % 251);
+  // the server reads these single bytes as login packets
+  if (p.angle == in_packet_t_start_login || p.angle == in_packet_t_username_skin) {
+    p.angle++;
+  }
+  Send(i, std::string(1, static_cast<char>(p.angle)));
+
+  if (!p.boost && rng.Next(50) == 0) {
+    p.boost = true;
+    Send(i, std::string(1, static_cast<char>(in_packet_t_start_acc)));
+  } else if (p.boost && rng.Next(5) == 0) {
+    p.boost = false;
+    Send(i, std::string(1, static_cast<char>(in_packet_t_stop_acc)));
+  }
+}
+
+void LoadGen::OnTimer(const websocketpp::lib::error_code &ec) {
+  if (ec) {
+    return;
+  }
+
+  const int64_t now = NowNs();
+  if (now - start_ns >= static_cast<int64_t>(options.secs) * 1000000000) {
+    running = false;
+    for (Player &p : players) {
+      if (p.stage != stage_idle && p.stage != stage_connecting) {
+        websocketpp::lib::error_code close_ec;
+        client.close(p.hdl, websocketpp::close::status::going_away, "", close_ec);
+      }
+    }
+    client.stop();
+    return;
+  }
+
+  // ramp up at `rate` connections per second, reconnects included
+  size_t budget = std::max<size_t>(1, options.rate * tick_ms / 1000);
+  for (size_t i = 0; i < players.size(); i++) {
+    Player &p = players[i];
+    if (p.stage == stage_idle && now >= p.retry_ns && budget > 0) {
+      Connect(i);
+      budget--;
+    } else if (p.stage == stage_playing) {
+      Steer(i);
+      // a lost pong is given up on after a second
+      const bool waiting = p.ping_ns != 0 && now - p.ping_ns < 4 * ping_interval_ns;
+      if (!waiting && now >= p.next_ping_ns) {
+        p.ping_ns = now;
+        p.next_ping_ns = now + ping_interval_ns;
+        Send(i, std::string(1, static_cast<char>(in_packet_t_ping)));
+      }
+    }
+  }
+
+  if (now - last_progress_ns >= progress_ns) {
+    PrintProgress(now);
+  }
+  if (running) {
+    client.set_timer(tick_ms, bind(&LoadGen::OnTimer, this, _1));
+  }
+}
+
+void LoadGen::OnOpen(size_t i, connection_hdl hdl) {
+  Player &p = players[i];
+  const int64_t now = NowNs();
+  connect_times.push_back(now - p.connect_ns);
+  opened++;
+  open++;
+  if (all_open_ns == 0 && opened == players.size()) {
+    all_open_ns = now;
+  }
+
+  p.stage = stage_login;
+  Send(i, std::string(1, static_cast<char>(in_packet_t_start_login)));
+}
+
+void LoadGen::OnFail(size_t i, connection_hdl hdl) {
+  failed++;
+  websocketpp::lib::error_code ec;
+  const WSClient::connection_ptr con = client.get_con_from_hdl(hdl, ec);
+  if (con) {
+    fail_reasons[con->get_ec().message()]++;
+  }
+  players[i].stage = stage_idle;
+  players[i].retry_ns = NowNs() + retry_ns;
+}
+
+void LoadGen::OnClose(size_t i, connection_hdl hdl) {
+  Disconnected(i);
+}
+
+void LoadGen::Disconnected(size_t i) {
+  Player &p = players[i];
+  if (p.stage == stage_playing) {
+    playing--;
+  }
+  open--;
+  p.stage = stage_idle;
+  p.retry_ns = NowNs() + retry_ns;
+}
+
+void LoadGen::OnMessage(size_t i, connection_hdl hdl, WSClient::message_ptr msg) {
+  const std::string &payload = msg->get_payload();
+  rx_bytes += payload.size();
+  rx_packets++;
+  if (payload.size() < 3) {
+    return;
+  }
+
+  // 2 bytes of client time, then the type
+  const uint8_t type = static_cast<uint8_t>(payload[2]);
+  type_count[type]++;
+  type_bytes[type] += payload.size();
+
+  Player &p = players[i];
+  switch (type) {
+    case '6':
+      if (p.stage == stage_login) {
+        SendLogin(i);
+      }
+      break;
+    case packet_t_init:
+      if (p.stage == stage_joining) {
+        p.stage = stage_playing;
+        playing++;
+        logins++;
+      }
+      break;
+    case packet_t_end:
+      if (p.stage == stage_playing) {
+        p.stage = stage_dead;
+        playing--;
+        deaths++;
+      }
+      break;
+    case packet_t_pong:
+      if (p.ping_ns != 0) {
+        ping_times.push_back(NowNs() - p.ping_ns);
+        p.ping_ns = 0;
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void LoadGen::PrintProgress(int64_t now) {
+  const double dt = (now - last_progress_ns) / 1e9;
+  printf("%5.0fs  open %zu  playing %zu  deaths %llu  rx %.2f MB/s  %.0f packets/s\n",
+         (now - start_ns) / 1e9, open, playing, static_cast<unsigned long long>(deaths),
+         (rx_bytes - last_rx_bytes) / dt / 1e6, (rx_packets - last_rx_packets) / dt);
+  fflush(stdout);
+  last_progress_ns = now;
+  last_rx_bytes = rx_bytes;
+  last_rx_packets = rx_packets;
+}
+
+void LoadGen::PrintReport() {
+  const double secs = (NowNs() - start_ns) / 1e9;
+  printf("\n%zu players (%s) for %.1f s\n", players.size(), options.protocol.c_str(), secs);
+
+  printf("connects: %llu started, %llu open, %llu failed, %llu logins, %llu deaths\n",
+         static_cast<unsigned long long>(connects), static_cast<unsigned long long>(opened),
+         static_cast<unsigned long long>(failed), static_cast<unsigned long long>(logins),
+         static_cast<unsigned long long>(deaths));
+  for (const auto &r : fail_reasons) {
+    printf("  %llu failed: %s\n", static_cast<unsigned long long>(r.second), r.first.c_str());
+  }
+  if (all_open_ns != 0) {
+    const double ramp = (all_open_ns - start_ns) / 1e9;
+    printf("all %zu open after %.2f s, %.1f connects/s\n", players.size(), ramp,
+           players.size() / ramp);
+  }
+  printf("connect ms: p50 %.2f  p99 %.2f  max %.2f\n", Percentile(&connect_times, 0.5),
+         Percentile(&connect_times, 0.99), Percentile(&connect_times, 1.0));
+
+  printf("received: %.2f MB, %llu packets, %.2f MB/s, %.0f packets/s; sent %llu packets\n",
+         rx_bytes / 1e6, static_cast<unsigned long long>(rx_packets), rx_bytes / secs / 1e6,
+         rx_packets / secs, static_cast<unsigned long long>(tx_packets));
+
+  std::vector<uint8_t> types;
+  for (int t = 0; t < 256; t++) {
+    if (type_count[t] > 0) {
+      types.push_back(static_cast<uint8_t>(t));
+    }
+  }
+  std::sort(types.begin(), types.end(),
+            [this](uint8_t a, uint8_t b) { return type_count[a] > type_count[b]; });
+  printf("%6s %12s %12s %8s\n", "type", "packets", "bytes", "avg");
+  for (uint8_t t : types) {
+    printf("%4c %02x %12llu %12llu %8.1f\n", t >= 32 && t < 127 ? t : '?', t,
+           static_cast<unsigned long long>(type_count[t]),
+           static_cast<unsigned long long>(type_bytes[t]),
+           static_cast<double>(type_bytes[t]) / type_count[t]);
+  }
+
+  printf("ping round trip ms (%zu): p50 %.2f  p90 %.2f  p99 %.2f  max %.2f\n",
+         ping_times.size(), Percentile(&ping_times, 0.5), Percentile(&ping_times, 0.9),
+         Percentile(&ping_times, 0.99), Percentile(&ping_times, 1.0));
+}
+
+void Usage(FILE *out) {
+  fprintf(out,
+          "usage: load_gen [--host H] [--port P] [--players N] [--secs S]\n"
+          "                [--rate R] [--protocol legacy|modern|mixed] [--seed S]\n");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options o;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h") {
+      Usage(stdout);
+      return 0;
+    }
+    if (i + 1 >= argc) {
+      fprintf(stderr, "missing value for %s\n", arg.c_str());
+      Usage(stderr);
+      return 2;
+    }
+    const char *value = argv[++i];
+    if (arg == "--host") {
+      o.host = value;
+    } else if (arg == "--port") {
+      o.port = static_cast<uint16_t>(atoi(value));
+    } else if (arg == "--players") {
+      o.players = static_cast<size_t>(atol(value));
+    } else if (arg == "--secs") {
+      o.secs = static_cast<uint32_t>(atol(value));
+    } else if (arg == "--rate") {
+      o.rate = static_cast<uint32_t>(atol(value));
+    } else if (arg == "--protocol") {
+      o.protocol = value;
+    } else if (arg == "--seed") {
+      o.seed = strtoull(value, nullptr, 10);
+    } else {
+      fprintf(stderr, "unknown option %s\n", arg.c_str());
+      Usage(stderr);
+      return 2;
+    }
+  }
+  if (o.protocol != "legacy" && o.protocol != "modern" && o.protocol != "mixed") {
+    fprintf(stderr, "--protocol is legacy, modern or mixed\n");
+    return 2;
+  }
+  if (o.players == 0) {
+    fprintf(stderr, "--players must be positive\n");
+    return 2;
+  }
+
+  LoadGen gen(o);
+  gen.Run();
+  gen.PrintReport();
+  return 0;
+}
@@ -0,0 +1,271 @@
+// Cross-check of the SectorSeq spatial queries against brute force.
+//
+// Fills the sectors with random food and snake boxes, each box registered in
+// every sector its circle overlaps, then compares on random inputs:
+// - ForEachFoodInRadius and FindNearestFood with a scan of all the food,
+// - ForEachSnakeInRadius with a scan of all the boxes,
+// - ForEachIndexOnSegment with the sectors whose square the segment crosses.
+// Food and segment queries reach past the map edges to cover the clamping,
+// snake queries start on the map as the game's do. Prints the first
+// mismatch of each query and exits with 1 if there was any.
+//
+//   ./bin/sector_check [--queries N] [--food N] [--boxes N] [--seed S]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "game/math.h"
+#include "game/random.h"
+#include "game/sector.h"
+
+namespace {
+
+struct Options {
+  uint32_t queries = 5000;
+  uint32_t food = 50000;
+  uint32_t boxes = 2000;
+  uint64_t seed = 1;
+};
+
+const float map_size = 1.0f * WorldConfig::sector_size * WorldConfig::sector_count_along_edge;
+
+float Uniform(Random *rng, float lo, float hi) { return lo + (hi - lo) * rng->Nextf(); }
+
+// Squared distance from (x, y) to the square of the sector, 0 inside.
+float SquareDistSq(const Sector &s, float x, float y) {
+  const float x0 = 1.0f * WorldConfig::sector_size * s.x;
+  const float y0 = 1.0f * WorldConfig::sector_size * s.y;
+  const float dx = std::max(std::max(x0 - x, 0.0f), x - (x0 + WorldConfig::sector_size));
+  const float dy = std::max(std::max(y0 - y, 0.0f), y - (y0 + WorldConfig::sector_size));
+  return dx * dx + dy * dy;
+}
+
+// Whether the segment a -> b crosses the square [x0, x1] x [y0, y1] (slabs).
+bool SegmentHitsSquare(float ax, float ay, float bx, float by, float x0, float y0, float x1,
+                       float y1) {
+  float t0 = 0.0f;
+  float t1 = 1.0f;
+  const float d[2] = {bx - ax, by - ay};
+  const float a[2] = {ax, ay};
+  const float lo[2] = {x0, y0};
+  const float hi[2] = {x1, y1};
+  for (int i = 0; i < 2; i++) {
+    if (d[i] == 0.0f) {
+      if (a[i] < lo[i] || a[i] > hi[i]) return false;
+      continue;
+    }
+    float ta = (lo[i] - a[i]) / d[i];
+    float tb = (hi[i] - a[i]) / d[i];
+    if (ta > tb) std::swap(ta, tb);
+    t0 = std::max(t0, ta);
+    t1 = std::min(t1, tb);
+    if (t0 > t1) return false;
+  }
+  return true;
+}
+
+bool CheckFood(const SectorSeq &ss, const std::vector<Food> &all, Random *rng) {
+  const float x = Uniform(rng, -500.0f, map_size + 500.0f);
+  const float y = Uniform(rng, -500.0f, map_size + 500.0f);
+  const float r = Uniform(rng, 1.0f, 1200.0f);
+
+  std::vector<uint64_t> got;
+  ss.ForEachFoodInRadius(x, y, r, [&](size_t, const Food &f) {
+    got.push_back(static_cast<uint64_t>(f.x) << 32 | static_cast<uint64_t>(f.y) << 16 |
+                  f.size << 8 | f.color);
+    return false;
+  });
+  std::vector<uint64_t> want;
+  std::vector<float> want_dist;
+  for (const Food &f : all) {
+    const float dx = f.x - x;
+    const float dy = f.y - y;
+    if (dx * dx + dy * dy < r * r) {
+      want.push_back(static_cast<uint64_t>(f.x) << 32 | static_cast<uint64_t>(f.y) << 16 |
+                     f.size << 8 | f.color);
+      want_dist.push_back(Math::dist_sq(x, y, f.x, f.y));
+    }
+  }
+  std::sort(got.begin(), got.end());
+  std::sort(want.begin(), want.end());
+  if (got != want) {
+    printf("ForEachFoodInRadius (%.1f, %.1f) r %.1f: %zu items, brute force %zu\n", x, y, r,
+           got.size(), want.size());
+    return false;
+  }
+
+  const size_t k = 1 + rng->Next(16);
+  std::vector<Food> nearest;
+  ss.FindNearestFood(x, y, r, k, &nearest);
+  std::sort(want_dist.begin(), want_dist.end());
+  want_dist.resize(std::min(k, want_dist.size()));
+  std::vector<float> got_dist;
+  for (const Food &f : nearest) {
+    got_dist.push_back(Math::dist_sq(x, y, f.x, f.y));
+  }
+  if (got_dist != want_dist) {
+    printf("FindNearestFood (%.1f, %.1f) r %.1f k %zu: %zu items, brute force %zu\n", x, y, r,
+           k, got_dist.size(), want_dist.size());
+    return false;
+  }
+  return true;
+}
+
+bool CheckSnakes(const SectorSeq &ss, const std::vector<SnakeBoundBox> &boxes, Random *rng) {
+  const BoundBoxPos area = {Uniform(rng, 0.0f, map_size), Uniform(rng, 0.0f, map_size),
+                            Uniform(rng, 1.0f, 1200.0f)};
+
+  std::set<snake_id_t> got;
+  ss.ForEachSnakeInRadius(area.x, area.y, area.r, [&](const BoundBox *bb) {
+    got.insert(bb->id);
+    return false;
+  });
+  std::set<snake_id_t> want;
+  for (const SnakeBoundBox &bb : boxes) {
+    if (bb.Intersect(area)) {
+      want.insert(bb.id);
+    }
+  }
+  if (got != want) {
+    printf("ForEachSnakeInRadius (%.1f, %.1f) r %.1f: %zu boxes, brute force %zu\n", area.x,
+           area.y, area.r, got.size(), want.size());
+    return false;
+  }
+  return true;
+}
+
+bool CheckSegment(Random *rng) {
+  const float ax = Uniform(rng, -1000.0f, map_size + 1000.0f);
+  const float ay = Uniform(rng, -1000.0f, map_size + 1000.0f);
+  const float len = Uniform(rng, 0.0f, 5000.0f);
+  const float angle = Uniform(rng, 0.0f, Math::f_2pi);
+  // axis aligned now and then
+  const float bx = rng->Next(8) == 0 ? ax : ax + len * cosf(angle);
+  const float by = rng->Next(8) == 0 ? ay : ay + len * sinf(angle);
+
+  std::vector<size_t> got;
+  SectorSeq::ForEachIndexOnSegment(ax, ay, bx, by, [&](size_t index) {
+    got.push_back(index);
+    return false;
+  });
+  std::vector<size_t> sorted(got);
+  std::sort(sorted.begin(), sorted.end());
+  if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+    printf("ForEachIndexOnSegment (%.1f, %.1f) -> (%.1f, %.1f) visits a sector twice\n", ax,
+           ay, bx, by);
+    return false;
+  }
+
+  // Crossings within eps of a sector edge may go either way.
+  const float eps = 0.01f;
+  const int32_t edge = WorldConfig::sector_count_along_edge;
+  for (int32_t j = 0; j < edge; j++) {
+    for (int32_t i = 0; i < edge; i++) {
+      const float x0 = 1.0f * WorldConfig::sector_size * i;
+      const float y0 = 1.0f * WorldConfig::sector_size * j;
+      const float x1 = x0 + WorldConfig::sector_size;
+      const float y1 = y0 + WorldConfig::sector_size;
+      const bool must = SegmentHitsSquare(ax, ay, bx, by, x0 + eps, y0 + eps, x1 - eps, y1 - eps);
+      const bool may = SegmentHitsSquare(ax, ay, bx, by, x0 - eps, y0 - eps, x1 + eps, y1 + eps);
+      const bool visited = std::binary_search(sorted.begin(), sorted.end(),
+                                              static_cast<size_t>(j) * edge + i);
+      if ((must && !visited) || (visited && !may)) {
+        printf("ForEachIndexOnSegment (%.1f, %.1f) -> (%.1f, %.1f): sector (%d, %d) %s\n", ax,
+               ay, bx, by, i, j, visited ? "visited, not crossed" : "crossed, not visited");
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void Usage(FILE *out) {
+  fprintf(out,
+          "usage: sector_check [--queries N] [--food N] [--boxes N] [--seed S]\n");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options o;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h") {
+      Usage(stdout);
+      return 0;
+    }
+    if (i + 1 >= argc) {
+      fprintf(stderr, "missing value for %s\n", arg.c_str());
+      Usage(stderr);
+      return 2;
+    }
+    const char *value = argv[++i];
+    if (arg == "--queries") {
+      o.queries = static_cast<uint32_t>(atol(value));
+    } else if (arg == "--food") {
+      o.food = static_cast<uint32_t>(atol(value));
+    } else if (arg == "--boxes") {
+      o.boxes = static_cast<uint32_t>(atol(value));
+    } else if (arg == "--seed") {
+      o.seed = strtoull(value, nullptr, 10);
+    } else {
+      fprintf(stderr, "unknown option %s\n", arg.c_str());
+      Usage(stderr);
+      return 2;
+    }
+  }
+
+  Random rng(o.seed, 0);
+  SectorSeq ss;
+  ss.InitSectors();
+
+  std::vector<Food> food;
+  for (uint32_t i = 0; i < o.food; i++) {
+    const Food f(static_cast<uint16_t>(rng.Next(static_cast<uint32_t>(map_size))),
+                 static_cast<uint16_t>(rng.Next(static_cast<uint32_t>(map_size))),
+                 static_cast<uint8_t>(1 + rng.Next(10)), static_cast<uint8_t>(rng.Next(29)));
+    ss[ss.get_index(f.x / WorldConfig::sector_size, f.y / WorldConfig::sector_size)].Insert(f);
+    food.push_back(f);
+  }
+
+  // Destroyed before the sectors, boxes unregister themselves.
+  std::vector<SnakeBoundBox> boxes;
+  boxes.reserve(o.boxes);
+  for (uint32_t i = 0; i < o.boxes; i++) {
+    const BoundBoxPos pos = {Uniform(&rng, 0.0f, map_size), Uniform(&rng, 0.0f, map_size),
+                             Uniform(&rng, 20.0f, 1500.0f)};
+    boxes.emplace_back(pos, static_cast<uint16_t>(i + 1), nullptr, SectorVec());
+    SnakeBoundBox &bb = boxes.back();
+    const int32_t r = static_cast<int32_t>(pos.r / WorldConfig::sector_size) + 1;
+    SectorSeq::ForEachIndexAround(SectorSeq::get_coord(pos.x), SectorSeq::get_coord(pos.y), r,
+                                  [&](size_t index) {
+      if (SquareDistSq(ss[index], pos.x, pos.y) <= pos.r * pos.r) {
+        bb.InsertSortedWithReg(&ss[index]);
+      }
+      return false;
+    });
+  }
+
+  const char *names[3] = {"food", "snakes", "segment"};
+  uint32_t failed[3] = {0, 0, 0};
+  for (uint32_t q = 0; q < o.queries; q++) {
+    const bool ok[3] = {failed[0] > 0 || CheckFood(ss, food, &rng),
+                        failed[1] > 0 || CheckSnakes(ss, boxes, &rng),
+                        failed[2] > 0 || CheckSegment(&rng)};
+    for (int i = 0; i < 3; i++) {
+      failed[i] += !ok[i];
+    }
+  }
+
+  int status = 0;
+  for (int i = 0; i < 3; i++) {
+    printf("%-8s %s\n", names[i], failed[i] > 0 ? "MISMATCH" : "ok");
+    status |= failed[i] > 0;
+  }
+  printf("%u queries each, %u food, %u boxes\n", o.queries, o.food, o.boxes);
+  return status;
+}
@@ -0,0 +1,248 @@
+// Determinism check of the simulation.
+//
+// Runs HeadlessSim in deterministic mode and hashes the world after every
+// frame (World::GetFrameHash).
+//
+//   ./bin/sim_check [--frames N] [--bots N] [--humans N] [--seed S]
+//                   [--threads A] [--against B]
+//                   [--record inputs.bin | --replay inputs.bin]
+//                   [--hashes out.txt]
+//   ./bin/sim_check --diff a.txt b.txt
+//
+// --against B runs a second world with B threads in lockstep and stops at
+// the first frame whose hash differs, naming the first snake or sector that
+// differs. To compare two builds, run each with --hashes (the second one
+// with --replay of the inputs the first one recorded) and --diff the files.
+// Builds to compare should use -DSTRICT_FLOAT=ON, so both compile the same
+// float operations.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "game/headless_sim.h"
+
+namespace {
+
+struct Options {
+  uint32_t frames = 2000;
+  uint16_t bots = 500;
+  uint16_t humans = 8;
+  uint64_t seed = 1;
+  uint16_t threads = 1;
+  uint16_t against = 0;
+  std::string record;
+  std::string replay;
+  std::string hashes;
+};
+
+std::unique_ptr<HeadlessSim> MakeSim(const Options &o, uint16_t threads) {
+  WorldConfig config;
+  config.bots = o.bots;
+  config.sim_threads = threads;
+  config.random_seed = o.seed;
+  config.deterministic = true;
+  return std::unique_ptr<HeadlessSim>(new HeadlessSim(config, o.humans));
+}
+
+bool SameFloat(float a, float b) { return std::memcmp(&a, &b, sizeof(a)) == 0; }
+
+// Prints the first snake (tick order) or sector that differs.
+void Describe(HeadlessSim *a, HeadlessSim *b) {
+  const SnakeVec &sa = a->get_world().GetTickOrder();
+  const SnakeVec &sb = b->get_world().GetTickOrder();
+  if (sa.size() != sb.size()) {
+    printf("  snake count %zu vs %zu\n", sa.size(), sb.size());
+    return;
+  }
+
+  for (size_t i = 0; i < sa.size(); i++) {
+    const Snake *x = sa[i];
+    const Snake *y = sb[i];
+    if (x->id != y->id || x->parts.size() != y->parts.size()) {
+      printf("  snake #%zu: id %u vs %u, %zu vs %zu parts\n", i, x->id, y->id,
+             x->parts.size(), y->parts.size());
+      return;
+    }
+    for (size_t k = 0; k < x->parts.size(); k++) {
+      const Body p = x->parts[k];
+      const Body q = y->parts[k];
+      if (!SameFloat(p.x, q.x) || !SameFloat(p.y, q.y)) {
+        printf("  snake %u part %zu: (%.9g, %.9g) vs (%.9g, %.9g)\n", x->id, k,
+               p.x, p.y, q.x, q.y);
+        return;
+      }
+    }
+    if (!SameFloat(x->angle, y->angle) || !SameFloat(x->wangle, y->wangle) ||
+        x->fullness != y->fullness) {
+      printf("  snake %u: angle %.9g vs %.9g, wangle %.9g vs %.9g, fullness %u vs %u\n",
+             x->id, x->angle, y->angle, x->wangle, y->wangle, x->fullness, y->fullness);
+      return;
+    }
+  }
+
+  const SectorSeq &ea = a->get_world().GetSectors();
+  const SectorSeq &eb = b->get_world().GetSectors();
+  for (size_t i = 0; i < ea.size(); i++) {
+    if (ea[i].food.size() != eb[i].food.size() || ea[i].food_value != eb[i].food_value) {
+      printf("  sector (%u, %u): %zu vs %zu food, value %u vs %u\n", ea[i].x, ea[i].y,
+             ea[i].food.size(), eb[i].food.size(), ea[i].food_value, eb[i].food_value);
+      return;
+    }
+  }
+}
+
+int Diff(const char *path_a, const char *path_b) {
+  std::ifstream a(path_a);
+  std::ifstream b(path_b);
+  if (!a || !b) {
+    fprintf(stderr, "cannot open %s or %s\n", path_a, path_b);
+    return 2;
+  }
+
+  uint32_t frame_a, frame_b;
+  std::string hash_a, hash_b;
+  uint32_t frames = 0;
+  while (a >> frame_a >> hash_a) {
+    if (!(b >> frame_b >> hash_b)) {
+      printf("%s ends after %u frames\n", path_b, frames);
+      return 1;
+    }
+    if (frame_a != frame_b || hash_a != hash_b) {
+      printf("first divergence at frame %u: %s vs %s\n", frame_a, hash_a.c_str(),
+             hash_b.c_str());
+      return 1;
+    }
+    frames++;
+  }
+  if (b >> frame_b) {
+    printf("%s ends after %u frames\n", path_a, frames);
+    return 1;
+  }
+  printf("identical, %u frames\n", frames);
+  return 0;
+}
+
+void Usage(FILE *out) {
+  fprintf(out,
+          "usage: sim_check [--frames N] [--bots N] [--humans N] [--seed S]\n"
+          "                 [--threads A] [--against B]\n"
+          "                 [--record inputs.bin | --replay inputs.bin]\n"
+          "                 [--hashes out.txt]\n"
+          "       sim_check --diff a.txt b.txt\n");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options o;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h") {
+      Usage(stdout);
+      return 0;
+    }
+    if (arg == "--diff" && i + 2 < argc) {
+      return Diff(argv[i + 1], argv[i + 2]);
+    }
+    if (i + 1 >= argc || arg == "--diff") {
+      fprintf(stderr, "missing value for %s\n", arg.c_str());
+      Usage(stderr);
+      return 2;
+    }
+    const char *value = argv[++i];
+    if (arg == "--frames") {
+      o.frames = static_cast<uint32_t>(atol(value));
+    } else if (arg == "--bots") {
+      o.bots = static_cast<uint16_t>(atoi(value));
+    } else if (arg == "--humans") {
+      o.humans = static_cast<uint16_t>(atoi(value));
+    } else if (arg == "--seed") {
+      o.seed = strtoull(value, nullptr, 10);
+    } else if (arg == "--threads") {
+      o.threads = static_cast<uint16_t>(atoi(value));
+    } else if (arg == "--against") {
+      o.against = static_cast<uint16_t>(atoi(value));
+    } else if (arg == "--record") {
+      o.record = value;
+    } else if (arg == "--replay") {
+      o.replay = value;
+    } else if (arg == "--hashes") {
+      o.hashes = value;
+    } else {
+      fprintf(stderr, "unknown option %s\n", arg.c_str());
+      Usage(stderr);
+      return 2;
+    }
+  }
+
+  std::unique_ptr<HeadlessSim> sim = MakeSim(o, o.threads);
+  std::unique_ptr<HeadlessSim> other;
+  if (o.against > 0) {
+    other = MakeSim(o, o.against);
+  }
+
+  if (!o.replay.empty()) {
+    SimInputLog log;
+    if (!log.Load(o.replay)) {
+      fprintf(stderr, "cannot read %s\n", o.replay.c_str());
+      return 2;
+    }
+    sim->Replay(log);
+    if (other) other->Replay(log);
+  }
+
+  FILE *hashes = nullptr;
+  if (!o.hashes.empty()) {
+    hashes = fopen(o.hashes.c_str(), "w");
+    if (hashes == nullptr) {
+      fprintf(stderr, "cannot write %s\n", o.hashes.c_str());
+      return 2;
+    }
+  }
+
+  int status = 0;
+  for (uint32_t f = 0; f < o.frames; f++) {
+    sim->Step();
+    const uint64_t h = sim->get_world().GetFrameHash();
+    if (hashes != nullptr) {
+      fprintf(hashes, "%u %016llx\n", sim->get_world().GetFrame(),
+              static_cast<unsigned long long>(h));
+    }
+
+    if (other) {
+      // Both script the same commands while their worlds agree.
+      other->Step();
+      const uint64_t h2 = other->get_world().GetFrameHash();
+      if (h != h2) {
+        printf("first divergence at frame %u: %016llx (%u threads) vs %016llx (%u threads)\n",
+               sim->get_world().GetFrame(), static_cast<unsigned long long>(h), o.threads,
+               static_cast<unsigned long long>(h2), o.against);
+        Describe(sim.get(), other.get());
+        status = 1;
+        break;
+      }
+    }
+  }
+
+  if (hashes != nullptr) {
+    fclose(hashes);
+  }
+  if (!o.record.empty() && !sim->get_inputs().Save(o.record)) {
+    fprintf(stderr, "cannot write %s\n", o.record.c_str());
+    return 2;
+  }
+
+  if (status == 0) {
+    printf("%u frames, seed %llu, %zu inputs, final hash %016llx%s\n",
+           sim->get_world().GetFrame(),
+           static_cast<unsigned long long>(sim->get_world().GetSeed()),
+           sim->get_inputs().size(),
+           static_cast<unsigned long long>(sim->get_world().GetFrameHash()),
+           other ? ", identical across thread counts" : "");
+  }
+  return status;
+}